@@ -66,6 +66,39 @@ function luna.SetGraphicBgColor(color) end
 ---@param color glm.vec3
 function luna.SetGraphicSunlight(dir, color) end
 
+---@param fps number
+function luna.SetTargetFps(fps) end
+
+---@param hz number
+function luna.SetSimulationRate(hz) end
+
+---@param count number
+function luna.ReserveActors(count) end
+
+---@param path string
+---@return boolean
+function luna.SaveScene(path) end
+
+---@param path string
+---@return boolean
+function luna.LoadScene(path) end
+
+---@param center glm.vec3
+---@param radius number
+---@return number[]
+function luna.QuerySphere(center, radius) end
+
+---@param min glm.vec3
+---@param max glm.vec3
+---@return number[]
+function luna.QueryBox(min, max) end
+
+---@param origin glm.vec3
+---@param dir glm.vec3
+---@param maxDist number
+---@return number, number
+function luna.RayCast(origin, dir, maxDist) end
+
 ---@class luna.Actor
 ---@field id number
 luna.Actor = {}
@@ -112,6 +145,48 @@ luna.PointLightActor = {}
 ---@return luna.PointLightActor
 function luna.NewPointLightActor(color, radius) end
 
+---@class luna.Prefab
+luna.Prefab = {}
+
+---@param name string?
+---@return luna.Prefab
+function luna.Prefab.new(name) end
+
+---@param modelPath string
+---@param upAxis glm.vec3?
+function luna.Prefab:setModel(modelPath, upAxis) end
+
+---@param sideLength number
+---@param color glm.vec3
+function luna.Prefab:setSquarePlane(sideLength, color) end
+
+---@param radius number
+---@param horizontalLine number
+---@param verticalLine number
+---@param color glm.vec3
+function luna.Prefab:setSphere(radius, horizontalLine, verticalLine, color) end
+
+---@param scale number
+function luna.Prefab:setScale(scale) end
+
+---@param halfExtent glm.vec3
+---@param isStatic boolean
+---@param bounciness number
+function luna.Prefab:setBoxBody(halfExtent, isStatic, bounciness) end
+
+---@param radius number
+---@param isStatic boolean
+---@param bounciness number
+function luna.Prefab:setSphereBody(radius, isStatic, bounciness) end
+
+---@return number
+function luna.Prefab:getInstanceCount() end
+
+---@param prefab luna.Prefab
+---@param position glm.vec3
+---@return luna.Actor
+function luna.InstantiatePrefab(prefab, position) end
+
 ---@class luna.Component
 luna.Component = {}
 
@@ -1,4 +1,5 @@
 return {
     require 'assets.scene.demo.physic_demo',
     require 'assets.scene.demo.static_scene',
-}
\ No newline at end of file
+    require 'assets.scene.demo.prefab_demo',
+}
@@ -0,0 +1,25 @@
+function prefabDemoScene()
+    local l = luna.Log.new()
+    l:info("prefab scene is running")
+
+    -- Static floor
+    local floor = luna.Prefab.new("Floor")
+    floor:setSquarePlane(20, glm.vec3.new(0, 0.1, 0.9))
+    floor:setBoxBody(glm.vec3.new(10, 0.1, 10), true, 0.5)
+    local floorAct = luna.InstantiatePrefab(floor, glm.vec3.new(0, -4, 0))
+    floorAct:setRotation(glm.angleAxis(glm.radians(-90), glm.vec3.new(1, 0, 0)))
+
+    -- Grid of balls, mesh is generated and uploaded once, every instance has its own body
+    local ball = luna.Prefab.new("Ball")
+    ball:setSphere(0.2, 12, 12, glm.vec3.new(0.3, 0.8, 0.1))
+    ball:setSphereBody(0.2, false, 0.6)
+    local gridSize = 10
+    luna.ReserveActors(gridSize * gridSize + 8)
+    for x = 1, gridSize do
+        for z = 1, gridSize do
+            local pos = glm.vec3.new((x - gridSize / 2) * 0.6, 2, (z - gridSize / 2) * 0.6)
+            luna.InstantiatePrefab(ball, pos)
+        end
+    end
+    l:info("spawned " .. ball:getInstanceCount() .. " balls")
+end
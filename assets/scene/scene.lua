@@ -18,6 +18,9 @@ function init()
     -- local pointLight = luna.NewPointLightActor(glm.vec3.new(1, 1, 1), 20)
     -- pointLight:setLocalPosition(glm.vec3.new(0, 5, 0))
 
+    -- Frame rate limit, 0 for uncapped
+    luna.SetTargetFps(60)
+
     -- Maybe do some additional configuration here like
     -- setting up screen resolution etc.
 end
@@ -27,3 +30,4 @@ init()
 -- Select demo here
 staticDemoScene()
 --physicDemoScene()
+--prefabDemoScene()
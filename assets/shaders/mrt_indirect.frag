@@ -0,0 +1,48 @@
+#version 460
+#extension GL_EXT_nonuniform_qualifier : require
+
+// gpu driven variant of mrt.frag, material and textures are looked up by slot
+// draws of one multi draw can share a subgroup, so the texture index is non uniform
+
+layout(location = 0) in vec3 inVertPos;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in mat3 inTBNMat;
+layout(location = 6) flat in uint inMaterialSlot;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec4 outNormal;
+layout(location = 2) out vec4 outVertPos;
+
+struct MaterialData {
+    vec4 diffuse;
+    vec4 emissive;
+    int textureToggle;
+    uint albedoSlot;
+    uint normalSlot;
+    uint aoRoughnessHeightSlot;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer MaterialBuffer { MaterialData materials[]; };
+layout(set = 1, binding = 1) uniform sampler2D textures[];
+
+void main() {
+    MaterialData mat = materials[inMaterialSlot];
+    // color
+    if ((mat.textureToggle & 1) == 1) {
+        outColor = texture(textures[nonuniformEXT(mat.albedoSlot)], inTexCoord);
+    } else {
+        outColor = vec4(mat.diffuse.rgb, 1);
+    }
+    // normal
+    if (((mat.textureToggle >> 1) & 1) == 1) {
+        vec4 normaSamp = texture(textures[nonuniformEXT(mat.normalSlot)], inTexCoord) * 2 - 1;
+        outNormal = vec4(inTBNMat * normaSamp.xyz, 1);
+    } else {
+        outNormal = vec4(inNormal, 1);
+    }
+    outVertPos = vec4(inVertPos, 1);
+    // UV
+    outNormal.a = inTexCoord.r;
+    outVertPos.a = inTexCoord.g;
+}
@@ -0,0 +1,66 @@
+#version 460
+
+// gpu driven variant of mrt.vert, one multi draw covers the whole scene
+// gl_DrawID finds the draw written by cull.comp, gl_InstanceIndex its visible instance
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 inTangent;
+layout(location = 4) in vec3 inBitangent;
+
+layout(location = 0) out vec3 outVertPos;
+layout(location = 1) out vec2 outTexCoord;
+layout(location = 2) out vec3 outNormal;
+layout(location = 3) out mat3 outTBNMat;
+layout(location = 6) flat out uint outMaterialSlot;
+
+struct InstanceData {
+    mat4 worldTransform;
+    uint batchIdx;
+};
+
+struct BatchData {
+    vec4 boundsMin;
+    vec4 boundsMax;
+    uint firstInstance;
+    uint instanceCount;
+};
+
+struct DrawData {
+    uint batchIdx;
+    uint materialSlot;
+    uint firstIndex;
+    uint indexCount;
+    int vertexOffset;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer InstanceBuffer { InstanceData instances[]; };
+layout(std430, set = 0, binding = 1) readonly buffer BatchBuffer { BatchData batches[]; };
+layout(std430, set = 0, binding = 2) readonly buffer DrawBuffer { DrawData draws[]; };
+layout(std430, set = 0, binding = 5) readonly buffer VisibleDrawBuffer { uint visibleDraws[]; };
+layout(std430, set = 0, binding = 6) readonly buffer VisibleInstanceBuffer {
+    uint visibleInstances[];
+};
+
+layout (push_constant) uniform PushConstantData {
+    mat4 viewTransform;
+    mat4 perspectiveTransform;
+} pushC;
+
+void main() {
+    DrawData draw = draws[visibleDraws[gl_DrawID]];
+    // commands start at instance 0, the batch range of the visible list gives the instance
+    uint instanceIdx = visibleInstances[batches[draw.batchIdx].firstInstance + gl_InstanceIndex];
+    mat4 viewModalTransform = pushC.viewTransform * instances[instanceIdx].worldTransform;
+
+    // same as mrt.vert from here
+    gl_Position = pushC.perspectiveTransform * viewModalTransform * vec4(inPosition, 1.0);
+    outVertPos = inPosition;
+    outTexCoord = inTexCoord;
+    mat3 normMatrix = transpose(inverse(mat3(viewModalTransform)));
+    outNormal = normalize(normMatrix * inNormal);
+    outTBNMat = mat3(normalize((viewModalTransform * vec4(inTangent, 1)).xyz),
+                    normalize((viewModalTransform * vec4(inBitangent, 1)).xyz), outNormal);
+    outMaterialSlot = draw.materialSlot;
+}
@@ -12,19 +12,48 @@ Actor::~Actor() {
     _components.clear();
 }
 
+void Actor::delayInit(ActorHandle handle, const std::shared_ptr<Engine>& engine) {
+    _handle = handle;
+    _engine = engine;
+    _transforms = &engine->getTransformSystem();
+    _componentPools = &engine->getComponentPools();
+    delayInit();
+}
+
+bool Actor::ComponentOrderLess::operator()(const std::shared_ptr<Component>& lhs,
+                                           const std::shared_ptr<Component>& rhs) const {
+    return *lhs < *rhs;
+}
+
+// pooled components are skipped here, engine runs their pool pass
 void Actor::update(float deltaTime) {
     if (_state == EActive) {
-        updateComponents(deltaTime);
         updateActor(deltaTime);
         for (const auto& comp : _components) {
-            comp->postUpdate();
+            if (!comp->isPooled() && comp->isTickEnabled()) comp->postUpdate();
+        }
+    }
+}
+
+void Actor::tieredUpdate(uint64_t step, float deltaTime) {
+    if (_state != EActive) return;
+    float tierDeltaTime;
+    if (_tierState.advance(step, deltaTime, tierDeltaTime)) update(tierDeltaTime);
+}
+
+void Actor::preRender(float alpha) {
+    if (_state == EActive) {
+        for (const auto& comp : _components) {
+            if (!comp->isPooled() && comp->isTickEnabled()) comp->preRender(alpha);
         }
+        actorPreRender(alpha);
     }
 }
 
-void Actor::updateComponents(float deltaTime) {
+void Actor::gatherUnpooledComponents(std::vector<Component*>& out) const {
+    if (_state != EActive) return;
     for (const auto& comp : _components) {
-        comp->update(deltaTime);
+        if (!comp->isPooled() && comp->isTickEnabled()) out.push_back(comp.get());
     }
 }
 
@@ -32,19 +61,62 @@ void Actor::processInput(const struct InputState& keyState) {
     // process input for components, then actor specific
     if (_state == EActive) {
         for (const auto& comp : _components) {
-            comp->processInput(keyState);
+            if (!comp->isPooled() && comp->isTickEnabled()) comp->processInput(keyState);
         }
         actorInput(keyState);
     }
 }
 
-void Actor::addComponent(const std::shared_ptr<Component>& component) {
+void Actor::transformChanged() {
+    for (const auto& comp : _components) {
+        comp->transformChanged();
+    }
+}
+
+void Actor::setState(State state) {
+    if (state == EDead && _state != EDead) {
+        _engine->markActorDead(_handle);
+    }
+    _state = state;
+    for (const auto& comp : _components) {
+        comp->_ownerActive = _state == EActive;
+    }
+}
+
+void Actor::setUpdateTier(UpdateTier tier) {
+    if (tier == _updateTier) return;
+    _updateTier = tier;
+    // phase from handle slot spreads same tier actors over the steps
+    _tierState.set(tier, actorHandleIndex(_handle));
+    for (const auto& comp : _components) {
+        comp->_tier.set(tier, actorHandleIndex(_handle));
+    }
+}
+
+void Actor::setTickFlags(uint32_t flags) {
+    if (flags == _tickFlags) return;
+    _engine->updateActorTick(_handle, _tickFlags, flags);
+    _tickFlags = flags;
+}
+
+void Actor::attachComponent(const std::shared_ptr<Component>& component, ComponentTypeId typeId) {
     if (_locked) {
         SLog::get()->warn("actor is locked, cannot add component");
         return;
     }
     // lower order at front with multiset property
     _components.insert(component);
+    component->_typeId = typeId;
+    component->_ownerActive = _state == EActive;
+    component->_tier.set(_updateTier, actorHandleIndex(_handle));
+    if (!component->isPooled()) {
+        // unpooled component is driven through its owner, owner has to tick
+        setTickFlags(ETickUpdate | ETickInput | ETickPreRender);
+    }
+    if (typeId < MAX_COMPONENT_TYPES && _componentTable[typeId] == nullptr) {
+        _componentTable[typeId] = component.get();
+        _componentMask |= ComponentMask{1} << typeId;
+    }
 }
 
 void Actor::removeComponent(const std::shared_ptr<Component>& component) {
@@ -53,36 +125,54 @@ void Actor::removeComponent(const std::shared_ptr<Component>& component) {
         return;
     }
     auto iter = std::find(_components.begin(), _components.end(), component);
-    if (iter != _components.end()) {
-        _components.erase(iter);
+    if (iter == _components.end()) {
+        return;
+    }
+    _components.erase(iter);
+
+    // refill table slot with another component of the same type if any
+    ComponentTypeId typeId = component->getTypeId();
+    if (typeId < MAX_COMPONENT_TYPES && _componentTable[typeId] == component.get()) {
+        _componentTable[typeId] = nullptr;
+        _componentMask &= ~(ComponentMask{1} << typeId);
+        for (const auto& c : _components) {
+            if (c->getTypeId() == typeId) {
+                _componentTable[typeId] = c.get();
+                _componentMask |= ComponentMask{1} << typeId;
+                break;
+            }
+        }
     }
 }
 
-void Actor::setParent(int parentId) {
-    if (_parentId != -1) {
-        // remove original parent reference
-        auto p = _engine->getActor(_parentId);
-        if (p == nullptr) {
-            auto l = SLog::get();
-            l->error(fmt::format("get engine actor returns null, id: {:d}", _parentId));
-            return;
-        } else {
+void Actor::setParent(ActorHandle parent) {
+    const ActorRegistry& registry = _engine->getActorRegistry();
+    Actor* newParent = registry.get(parent);
+    if (parent != INVALID_ACTOR_HANDLE && newParent == nullptr) {
+        auto l = SLog::get();
+        l->error(fmt::format("set parent with stale actor handle {:#x}", parent));
+        return;
+    }
+    if (!transforms().setParent(getId(), parent)) {
+        return;  // would create a cycle
+    }
+
+    if (_parentId != INVALID_ACTOR_HANDLE) {
+        // remove original parent reference, parent may already be gone
+        Actor* p = registry.get(_parentId);
+        if (p != nullptr) {
             p->removeChild(getId());
         }
     }
 
-    _parentId = parentId;
-    auto p = _engine->getActor(_parentId);
-    if (p == nullptr) {
-        auto l = SLog::get();
-        l->error(fmt::format("get engine actor returns null, id: {:d}", _parentId));
-        return;
-    } else {
-        p->addChild(getId());
+    _parentId = parent;
+    if (newParent != nullptr) {
+        newParent->addChild(getId());
     }
+    _engine->actorParentChanged(getId(), newParent == nullptr);
 }
 
-void Actor::addChild(int childId) {
+void Actor::addChild(ActorHandle childId) {
     if (_locked) {
         SLog::get()->warn("actor is locked, cannot add children");
         return;
@@ -90,7 +180,7 @@ void Actor::addChild(int childId) {
     _childrenIdList.insert(childId);
 }
 
-void Actor::removeChild(int childId) {
+void Actor::removeChild(ActorHandle childId) {
     if (_locked) {
         SLog::get()->warn("actor is locked, cannot remove children");
         return;
@@ -98,73 +188,4 @@ void Actor::removeChild(int childId) {
     _childrenIdList.erase(childId);
 }
 
-const glm::mat4& Actor::getLocalTransform() {
-    if (_recomputeLocalTransform) {
-        _recomputeLocalTransform = false;
-        // Scale, then rotate, then translate
-        glm::mat4 scaleMat{};
-        scaleMat[0][0] = _scale;
-        scaleMat[1][1] = _scale;
-        scaleMat[2][2] = _scale;
-        scaleMat[3][3] = 1;
-        _localTransform = glm::translate(glm::identity<glm::mat4>(), _position) *
-                          glm::mat4_cast(_rotation) * scaleMat;
-    }
-    return _localTransform;
-}
-
-glm::mat4 Actor::getWorldTransform() {
-    // TODO: optimise into cache
-    glm::mat4 worldTransform = getLocalTransform();
-    int recParentId = _parentId;
-    while (recParentId != -1) {
-        auto p = _engine->getActor(recParentId);
-        if (p == nullptr) {
-            auto l = SLog::get();
-            l->error(fmt::format("get engine actor returns null, id: {:d}", recParentId));
-            break;
-        } else {
-            worldTransform = p->getLocalTransform() * worldTransform;
-            recParentId = p->getParentId();
-        }
-    }
-    return worldTransform;
-}
-
-glm::vec3 Actor::getWorldPosition() const {
-    // TODO: optimise into cache
-    glm::vec3 finalPos = getLocalPosition();
-    int recParentId = _parentId;
-    while (recParentId != -1) {
-        auto p = _engine->getActor(recParentId);
-        if (p == nullptr) {
-            auto l = SLog::get();
-            l->error(fmt::format("get engine actor returns null, id: {:d}", recParentId));
-            break;
-        } else {
-            finalPos += p->getLocalPosition();
-            recParentId = p->getParentId();
-        }
-    }
-    return finalPos;
-}
-
-void Actor::setWorldPosition(const glm::vec3& pos) {
-    glm::vec3 relPos = pos;
-    int recParentId = _parentId;
-    while (recParentId != -1) {
-        auto p = _engine->getActor(recParentId);
-        if (p == nullptr) {
-            auto l = SLog::get();
-            l->error(fmt::format("get engine actor returns null, id: {:d}", recParentId));
-            break;
-        } else {
-            relPos -= p->getLocalPosition();
-            recParentId = p->getParentId();
-        }
-    }
-    _position = relPos;
-    _recomputeLocalTransform = true;
-}
-
 }  // namespace luna
\ No newline at end of file
@@ -1,7 +1,13 @@
 #pragma once
 
 #include "utils/common.hpp"
+#include "core/scene/actor_registry.hpp"
+#include "core/scene/transform_system.hpp"
+#include "core/scene/component_pool.hpp"
+#include "core/scene/update_tier.hpp"
+#include "components/component_type.hpp"
 
+#include <cassert>
 #include <set>
 #include <unordered_set>
 #include <glm/gtx/euler_angles.hpp>
@@ -17,17 +23,15 @@ class Actor {
     public:
         // Only update in Active state, Will remove in EDead.
         enum State { EActive, EPause, EDead };
+        // per frame work an actor subscribes to, none by default so static actor costs nothing
+        enum TickFlag { ETickNone = 0, ETickUpdate = 1, ETickInput = 2, ETickPreRender = 4 };
 
         // delay init after proper reference is obtained from engine
         explicit Actor() = default;
         virtual ~Actor();
 
         virtual void delayInit() = 0;
-        void delayInit(int actorId, const std::shared_ptr<Engine>& engine) {
-            _actorWorldId = actorId;
-            _engine = engine;
-            delayInit();
-        }
+        void delayInit(ActorHandle handle, const std::shared_ptr<Engine>& engine);
 
         // Debug Display related
         virtual std::string displayName() = 0;
@@ -35,43 +39,56 @@ class Actor {
             if (!_cacheDisplayName.empty()) {
                 return _cacheDisplayName;
             }
-            _cacheDisplayName = fmt::format("{:s}({:d})", displayName(), _actorWorldId);
+            _cacheDisplayName = fmt::format("{:s}({:d}:{:d})", displayName(),
+                                            actorHandleIndex(_handle),
+                                            actorHandleGeneration(_handle));
             return _cacheDisplayName;
         };
 
-        // Update related (world, components, actor specific)
+        // Update related (actor specific, then unpooled post update), runs once per fixed
+        // simulation step after engine ran every component update bucket
         void update(float deltaTime);
-        void updateComponents(float deltaTime);
         virtual void updateActor(float deltaTime) {};
+        // update only on steps the update tier is due, with delta accumulated since last run
+        void tieredUpdate(uint64_t step, float deltaTime);
+        // unpooled components join the engine update buckets, pooled ones are run by their pool
+        void gatherUnpooledComponents(std::vector<Component*>& out) const;
+
+        // runs once per rendered frame after simulation, alpha blends previous and current step
+        void preRender(float alpha);
+        virtual void actorPreRender(float alpha) {};
 
         // Process input for actor and components
         void processInput(const struct InputState& keyState);
         virtual void actorInput(const struct InputState& keyState) {};
 
-        // Setter
-        void setLocalPosition(const glm::vec3& pos) {
-            _position = pos;
-            _recomputeLocalTransform = true;
-        }
-        void setWorldPosition(const glm::vec3& pos);
-        void setScale(float scale) {
-            _scale = scale;
-            _recomputeLocalTransform = true;
-        }
+        // forward owner transform change to components
+        void transformChanged();
+
+        // Setter, transform lives in engine transform system
+        void setLocalPosition(const glm::vec3& pos) { transforms().setLocalPosition(_handle, pos); }
+        void setWorldPosition(const glm::vec3& pos) { transforms().setWorldPosition(_handle, pos); }
+        void setScale(float scale) { transforms().setLocalScale(_handle, scale); }
         void setRotation(const glm::quat& rotation) {
-            _rotation = rotation;
-            _recomputeLocalTransform = true;
+            transforms().setLocalRotation(_handle, rotation);
         }
-        void setState(State state) { _state = state; }
+        void setState(State state);
+        void setTickFlags(uint32_t flags);
+        // also applies to components, accumulated delta carries over a tier change
+        void setUpdateTier(UpdateTier tier);
+        // engine assigns tier from camera distance and visibility, turn off to pin the tier
+        void setAutoUpdateTier(bool autoTier) { _autoUpdateTier = autoTier; }
         void setLock(bool lock) { _locked = lock; };
-        void setParent(int parentId);
+        void setParent(ActorHandle parent);
         void setDebugUiExpand(bool expand) { _debugUiExpanded = expand; };
 
         // Getter
-        [[nodiscard]] const glm::vec3& getLocalPosition() const { return _position; }
-        [[nodiscard]] glm::vec3 getWorldPosition() const;
+        [[nodiscard]] glm::vec3 getLocalPosition() const {
+            return transforms().getLocalPosition(_handle);
+        }
+        [[nodiscard]] glm::vec3 getWorldPosition() const { return getWorldTransform()[3]; }
         [[nodiscard]] glm::vec3 getForward() const {
-            return glm::mat4_cast(_rotation) * glm::vec4(0, 0, -1, 1);
+            return glm::mat4_cast(getRotation()) * glm::vec4(0, 0, -1, 1);
         };
         [[nodiscard]] glm::vec3 getRight() const {
             return glm::normalize(glm::cross(getForward(), glm::vec3{0, 1, 0}));
@@ -79,34 +96,80 @@ class Actor {
         [[nodiscard]] glm::vec3 getUp() const {
             return glm::normalize(glm::cross(getRight(), getForward()));
         };
-        [[nodiscard]] float getScale() const { return _scale; }
-        [[nodiscard]] const glm::quat& getRotation() const { return _rotation; }
+        [[nodiscard]] float getScale() const { return transforms().getLocalScale(_handle); }
+        [[nodiscard]] glm::quat getRotation() const {
+            return transforms().getLocalRotation(_handle);
+        }
         [[nodiscard]] State getState() const { return _state; }
-        [[nodiscard]] const glm::mat4& getLocalTransform();
-        [[nodiscard]] glm::mat4 getWorldTransform();
+        [[nodiscard]] uint32_t getTickFlags() const { return _tickFlags; }
+        [[nodiscard]] UpdateTier getUpdateTier() const { return _updateTier; }
+        [[nodiscard]] bool isAutoUpdateTier() const { return _autoUpdateTier; }
+        [[nodiscard]] glm::mat4 getLocalTransform() const {
+            return transforms().getLocalTransform(_handle);
+        }
+        [[nodiscard]] glm::mat4 getWorldTransform() const {
+            return transforms().getWorldTransform(_handle);
+        }
+        [[nodiscard]] glm::vec3 getInterpolatedLocalPosition(float alpha) const {
+            return transforms().getInterpolatedLocalPosition(_handle, alpha);
+        }
+        [[nodiscard]] glm::quat getInterpolatedRotation(float alpha) const {
+            return transforms().getInterpolatedLocalRotation(_handle, alpha);
+        }
+        // blended in the transform system before preRender
+        [[nodiscard]] glm::mat4 getInterpolatedWorldTransform() const {
+            return transforms().getInterpolatedWorldTransform(_handle);
+        }
         [[nodiscard]] std::shared_ptr<Engine> getEngine() { return _engine; }
-        [[nodiscard]] int getId() { return _actorWorldId; }
-        [[nodiscard]] int getParentId() { return _parentId; }
+        [[nodiscard]] ActorHandle getId() const { return _handle; }
+        [[nodiscard]] ActorHandle getParentId() const { return _parentId; }
         [[nodiscard]] int getDebugUiExpand() { return _debugUiExpanded; }
-        [[nodiscard]] const std::unordered_set<int>& getChildrenIdList() { return _childrenIdList; }
+        [[nodiscard]] const std::unordered_set<ActorHandle>& getChildrenIdList() {
+            return _childrenIdList;
+        }
 
         // Helper function
-        void addComponent(const std::shared_ptr<Component>& component);
+        // create from the engine component pool of T (plain allocation if T is not pooled)
+        template <class T>
+        std::shared_ptr<T> createComponent();
+        template <class T>
+        void addComponent(const std::shared_ptr<T>& component);
         void removeComponent(const std::shared_ptr<Component>& component);
 
+        // typed lookup is a single table load, first attached component of that type wins
+        // returned pointer is owned by actor, valid until the component is removed
+        template <class T>
+        T* getComponent() const;
         template <class T>
-        std::shared_ptr<T> getComponent();
+        bool hasComponent() const;
 
     private:
-        void addChild(int childId);
-        void removeChild(int childId);
+        // transform slot only exists after delayInit, catch constructor access in debug
+        [[nodiscard]] TransformSystem& transforms() const {
+            assert(_transforms != nullptr && "actor transform accessed before delayInit");
+            return *_transforms;
+        }
+        void attachComponent(const std::shared_ptr<Component>& component, ComponentTypeId typeId);
+        void addChild(ActorHandle childId);
+        void removeChild(ActorHandle childId);
 
         // Actor state & components
         State _state = EActive;
-        bool _recomputeLocalTransform = true;  // when our transform change we need to recalculate
-        std::multiset<std::shared_ptr<Component>> _components;
+        uint32_t _tickFlags = ETickNone;
+        UpdateTier _updateTier = ETierEveryStep;
+        UpdateTierState _tierState;
+        bool _autoUpdateTier = true;
+        struct ComponentOrderLess {
+                bool operator()(const std::shared_ptr<Component>& lhs,
+                                const std::shared_ptr<Component>& rhs) const;
+        };
+        std::multiset<std::shared_ptr<Component>, ComponentOrderLess> _components;
+        std::array<Component*, MAX_COMPONENT_TYPES> _componentTable{};
+        ComponentMask _componentMask = 0;
         std::shared_ptr<Engine> _engine;
-        int _actorWorldId = -1;
+        ActorHandle _handle = INVALID_ACTOR_HANDLE;
+        TransformSystem* _transforms = nullptr;  // owned by engine, outlives actor
+        ComponentPools* _componentPools = nullptr;
 
         // debug ui
         bool _debugUiExpanded = false;
@@ -115,15 +178,8 @@ class Actor {
         // Hierarchy
         bool _locked = false;  // locked means we cannot further modify the structure of the actor
                                // (component/child)
-        int _parentId = -1;
-        std::unordered_set<int> _childrenIdList;
-
-        // Transform related
-        glm::mat4 _cacheWorldTransform{};
-        glm::mat4 _localTransform{};
-        glm::vec3 _position{};
-        glm::quat _rotation = glm::angleAxis(glm::radians(0.f), glm::vec3(0.f, 1.f, 0.f));
-        float _scale = 1;
+        ActorHandle _parentId = INVALID_ACTOR_HANDLE;
+        std::unordered_set<ActorHandle> _childrenIdList;
 };
 
 }  // namespace luna
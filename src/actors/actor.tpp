@@ -1,13 +1,27 @@
+#include "components/component.hpp"
 
 namespace luna {
-template<class T>
-std::shared_ptr<T> Actor::getComponent() {
-    for (const auto &c: _components) {
-        std::shared_ptr<T> derivedPtr = std::dynamic_pointer_cast<T>(c);
-        if (derivedPtr) {
-            return derivedPtr;
-        }
-    }
-    return nullptr;
+template <class T>
+std::shared_ptr<T> Actor::createComponent() {
+    std::shared_ptr<T> component = _componentPools->create<T>(_engine, _handle);
+    addComponent(component);
+    return component;
 }
+
+template <class T>
+void Actor::addComponent(const std::shared_ptr<T>& component) {
+    static_assert(std::is_base_of_v<Component, T> && !std::is_same_v<Component, T>,
+                  "add component with its concrete type so the type id is known");
+    attachComponent(component, componentTypeId<T>());
+}
+
+template <class T>
+T* Actor::getComponent() const {
+    return static_cast<T*>(_componentTable[componentTypeId<T>()]);
+}
+
+template <class T>
+bool Actor::hasComponent() const {
+    return (_componentMask & componentBit<T>()) != 0;
 }
+}  // namespace luna
@@ -6,10 +6,23 @@
 
 namespace luna {
 
-void PointLightActor::delayInit() {}
+PointLightActor::~PointLightActor() {
+    if (_bvhProxy != DynamicBvh::NULL_NODE) getEngine()->getSpatialIndex().destroyProxy(_bvhProxy);
+}
+
+void PointLightActor::delayInit() {
+    // transform lives in engine transform system, only reachable after delay init
+    setScale(_ballSize);
+    _lightPos = getWorldTransform()[3];
+    _bvhProxy = getEngine()->getSpatialIndex().createProxy(Aabb::fromSphere(_lightPos, _radius),
+                                                           getId(), this, ESpatialLight);
+    // engine picks the lights sent to renderer from spatial index every frame
+    setTickFlags(ETickPreRender);
+}
 
-void PointLightActor::updateActor(float deltaTime) {
-    getEngine()->getRenderer()->setLightInfo(getLocalPosition(), _color, _radius);
+void PointLightActor::actorPreRender(float alpha) {
+    _lightPos = getInterpolatedWorldTransform()[3];
+    getEngine()->getSpatialIndex().moveProxy(_bvhProxy, Aabb::fromSphere(_lightPos, _radius));
 }
 
 }  // namespace luna
\ No newline at end of file
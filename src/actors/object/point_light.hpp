@@ -1,6 +1,7 @@
 #pragma once
 
 #include "actors/actor.hpp"
+#include "core/scene/dynamic_bvh.hpp"
 
 namespace luna {
 
@@ -12,19 +13,27 @@ class PointLightActor : public Actor {
     public:
         explicit PointLightActor(glm::vec3 color = glm::vec3{1, 1, 1}, float ballSize = 0.3,
                                  float radius = 10)
-            : Actor(), _color(color), _radius(radius) {
-            setScale(ballSize);
-        };
+            : Actor(), _radius(radius), _color(color), _ballSize(ballSize) {};
+        ~PointLightActor() override;
 
         void delayInit() override;
-        void updateActor(float deltaTime) override;
+        void actorPreRender(float alpha) override;
         std::string displayName() override { return "PointLightActor"; }
 
+        [[nodiscard]] glm::vec3 getColor() const { return _color; }
+        [[nodiscard]] float getRadius() const { return _radius; }
+        [[nodiscard]] float getBallSize() const { return _ballSize; }
+        // world position as of the last preRender
+        [[nodiscard]] glm::vec3 getLightPosition() const { return _lightPos; }
+
     private:
         std::shared_ptr<TweenComponent> _tweenComp;
         std::shared_ptr<MeshComponent> _meshComp;
         float _radius;
         glm::vec3 _color;
+        float _ballSize;
+        glm::vec3 _lightPos{};
+        int32_t _bvhProxy = DynamicBvh::NULL_NODE;  // bounds of the lit sphere
 };
 
 }  // namespace luna
\ No newline at end of file
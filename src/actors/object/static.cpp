@@ -3,12 +3,11 @@
 
 namespace luna {
 void StaticActor::delayInit() {
-    _meshComp = std::make_shared<MeshComponent>(getEngine(), getId());
+    _meshComp = createComponent<MeshComponent>();
     if (!_modelPath.empty()) {
         _meshComp->loadModal(_modelPath);
         _meshComp->uploadToGpu();
     }
-    addComponent(_meshComp);
 }
 
 }  // namespace luna
\ No newline at end of file
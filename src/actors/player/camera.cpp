@@ -15,14 +15,20 @@ constexpr float MIN_ANGLE_PITCH = -85;
 constexpr float MAX_ANGLE_PITCH = 85;
 
 void CameraActor::delayInit() {
-    _moveComp = std::make_shared<MoveComponent>(getEngine(), getId());
-    addComponent(_moveComp);
+    _moveComp = createComponent<MoveComponent>();
+    setTickFlags(ETickUpdate | ETickInput | ETickPreRender);
+    // viewer always updates every step, tiers of everything else are measured from here
+    setAutoUpdateTier(false);
+    getEngine()->setActiveCamera(getId());
 }
 
 void CameraActor::updateActor(float deltaTime) {
+    // input is sampled per frame, consume it on the first step only
+    glm::vec2 mouseOffset = _pendingMouseOffset;
+    _pendingMouseOffset = {};
+
     // set new camera rotation
     if (_moveComp->getEnabled()) {
-        glm::vec2 mouseOffset = getEngine()->getInputSystem()->getState().Mouse.getOffsetPosition();
         //        if (mouseOffset.x < 20 && mouseOffset.y < 20) {
         _yawAngle = (_yawAngle - mouseOffset.x * HOR_ANGLE_SPEED * deltaTime);
         _pitchAngle = glm::clamp(_pitchAngle - mouseOffset.y * VERT_ANGLE_SPEED * deltaTime,
@@ -37,11 +43,15 @@ void CameraActor::updateActor(float deltaTime) {
         // set rotation, yaw first then pitch
         setRotation(glm::eulerAngleYX(glm::radians(_yawAngle), glm::radians(_pitchAngle)));
     }
+}
 
+void CameraActor::actorPreRender(float alpha) {
     // Compute new camera from this actor
-    getEngine()->getRenderer()->setViewMatrix(getCamViewTransform());
+    glm::vec3 camPos = getInterpolatedLocalPosition(alpha);
+    glm::vec3 lookAtDir = glm::mat4_cast(getInterpolatedRotation(alpha)) * glm::vec4(0, 0, -1, 1);
+    getEngine()->getRenderer()->setViewMatrix(buildViewTransform(camPos, lookAtDir));
     getEngine()->getRenderer()->setProjectionMatrix(getPerspectiveTransformMatrix());
-    getEngine()->getRenderer()->setCamPos(getLocalPosition());
+    getEngine()->getRenderer()->setCamPos(camPos);
 
     // update ui
     getEngine()->getRenderer()->writeDebugUi(
@@ -59,6 +69,7 @@ void CameraActor::updateActor(float deltaTime) {
 void CameraActor::actorInput(const struct InputState &state) {
     float forwardSpeed = 0.0f;
     float strafSpeed = 0.0f;
+    _pendingMouseOffset += state.Mouse.getOffsetPosition();
 
     // wasd movement
     if (state.Keyboard.getKeyState(SDL_SCANCODE_P) == EPressed) {
@@ -91,15 +102,16 @@ void CameraActor::actorInput(const struct InputState &state) {
 // our world coordinate is x right, y up, z in
 // get the object in camera space
 glm::mat4 CameraActor::getCamViewTransform() {
+    return buildViewTransform(getLocalPosition(), getForward());
+}
+
+glm::mat4 CameraActor::buildViewTransform(const glm::vec3 &pos, const glm::vec3 &lookAtDir) {
     // transform to camera space
     // Build look at matrix (combine new basis axis and translation)
     // The rotation is inverse of R = transpose of R
     // carefully study the cross product axis! thus we need to have -lookAtDir
     glm::vec3 upVec(0, 1, 0);
 
-    // calculate forward vector from two rotation angle, already normalised
-    glm::vec3 lookAtDir = getForward();
-
     // use cross product to determine cam base axis, RH rules
     glm::vec3 right = glm::normalize(glm::cross(lookAtDir, upVec));
     glm::vec3 camUp = glm::normalize(glm::cross(right, lookAtDir));
@@ -108,8 +120,7 @@ glm::mat4 CameraActor::getCamViewTransform() {
         glm::vec4{right.x, camUp.x, -lookAtDir.x, 0},
         glm::vec4{right.y, camUp.y, -lookAtDir.y, 0},
         glm::vec4{right.z, camUp.z, -lookAtDir.z, 0},
-        glm::vec4{-glm::dot(getLocalPosition(), right), -glm::dot(getLocalPosition(), camUp),
-                  glm::dot(getLocalPosition(), lookAtDir), 1},
+        glm::vec4{-glm::dot(pos, right), -glm::dot(pos, camUp), glm::dot(pos, lookAtDir), 1},
     };  // construct new axis, where 4th arg is the translation
     // REMEMBER translation is the projection of the lenght onto the NEW axis, so
     // you can't just straight up use position.x!! Must be projected into the new axis
@@ -14,13 +14,18 @@ class CameraActor : public Actor {
 
         void delayInit() override;
         void updateActor(float deltaTime) override;
+        void actorPreRender(float alpha) override;
         void actorInput(const struct InputState &state) override;
         std::string displayName() override { return "CameraActor"; }
 
         // utils
         glm::mat4 getCamViewTransform();
+        static glm::mat4 buildViewTransform(const glm::vec3 &pos, const glm::vec3 &lookAtDir);
         glm::mat4 getPerspectiveTransformMatrix();
         glm::mat4 getOrthographicTransformMatrix();
+        [[nodiscard]] float getNearDepth() const { return _nearDepth; }
+        [[nodiscard]] float getFarDepth() const { return _farDepth; }
+        [[nodiscard]] float getFovY() const { return _fovYInAngle; }
 
     private:
         // cam config
@@ -31,6 +36,7 @@ class CameraActor : public Actor {
         // rotation, look to z
         float _pitchAngle = 0;  // head updown [-85, 85], ++ up
         float _yawAngle = 0;    // head rightleft [0, 360], ++ to the right, clockwise
+        glm::vec2 _pendingMouseOffset{};  // mouse moved since last simulation step
 
         std::shared_ptr<MoveComponent> _moveComp;
 };
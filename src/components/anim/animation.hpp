@@ -6,7 +6,9 @@ namespace luna {
 
 class AnimationComponent : public Component {
     public:
-        explicit AnimationComponent(const std::shared_ptr<Engine> &engine, int ownerId);
+        static constexpr ComponentTypeId TypeId = EComponentAnimation;
+
+        explicit AnimationComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId);
         ~AnimationComponent() override;
 };
 
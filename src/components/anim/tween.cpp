@@ -4,8 +4,11 @@
 
 namespace luna {
 
-TweenComponent::TweenComponent(const std::shared_ptr<Engine>& engine, int ownerId, int updateOrder)
-    : Component(engine, ownerId, updateOrder) {}
+TweenComponent::TweenComponent(const std::shared_ptr<Engine>& engine, ActorHandle ownerId,
+                               int updateOrder)
+    : Component(engine, ownerId, updateOrder) {
+    setTickEnabled(false);  // nothing to play until a sequence is added
+}
 
 void TweenComponent::update(float deltaTime) {
     if (!getEnabled() || _animSeqList.empty()) {
@@ -30,6 +33,7 @@ void TweenComponent::update(float deltaTime) {
         // special ending condition
         if (_loopType == EOneShot && _curSeqBlock + 1 == _animSeqList.size()) {
             setEnable(false);
+            setTickEnabled(false);  // idle until a new sequence is added
             _curSeqBlock = 0;
             _accumTimestampS = 0;
             return;
@@ -44,6 +48,7 @@ TweenComponent& TweenComponent::addTranslateOffset(float durS, glm::vec3 offSet,
     // TODO: validation duration
     std::unique_ptr<SeqBlock> seqPtr = std::make_unique<SeqBlock>();
     seqPtr->durationS = durS;
+    setTickEnabled(getEnabled());
     seqPtr->invokeF = [this, offSet, easeType](float globalPerc, float stepDelta) {
         float actualPerc =
             getEaseVal(easeType, globalPerc) - getEaseVal(easeType, globalPerc - stepDelta);
@@ -61,6 +66,7 @@ TweenComponent& TweenComponent::addRotationOffset(float durS, float totalAngle,
     // TODO: validation duration
     std::unique_ptr<SeqBlock> seqPtr = std::make_unique<SeqBlock>();
     seqPtr->durationS = durS;
+    setTickEnabled(getEnabled());
     seqPtr->invokeF = [this, axis, totalAngle, easeType](float globalPerc, float stepDelta) {
         float actualPerc =
             getEaseVal(easeType, globalPerc) - getEaseVal(easeType, globalPerc - stepDelta);
@@ -9,7 +9,9 @@ namespace luna {
 
 class TweenComponent : public Component {
     public:
-        explicit TweenComponent(const std::shared_ptr<Engine>& engine, int ownerId,
+        static constexpr ComponentTypeId TypeId = EComponentTween;
+
+        explicit TweenComponent(const std::shared_ptr<Engine>& engine, ActorHandle ownerId,
                                 int updateOrder = 10);
 
         enum EaseType { EEaseLinear, EEaseInOutQuad };
@@ -2,19 +2,24 @@
 
 #include "core/engine.hpp"
 #include "actors/actor.hpp"
+#include "core/scene/component_pool.hpp"
 
 namespace luna {
 
-Component::Component(std::shared_ptr<Engine> engine, int ownerId, int updateOrder)
+Component::Component(std::shared_ptr<Engine> engine, ActorHandle ownerId, int updateOrder)
     : _engine(std::move(engine)), _ownerId(ownerId), _updateOrder(updateOrder) {}
 
+void Component::setTickEnabled(bool tick) {
+    if (_tickEnabled == tick) return;
+    _tickEnabled = tick;
+    if (_pool != nullptr) _pool->markTickDirty();
+}
+
 bool Component::operator<(const Component &rhs) const { return _updateOrder < rhs._updateOrder; }
 
 std::shared_ptr<Actor> Component::getOwner() {
-    if (_parentCache.expired()) {
-        _parentCache = _engine->getActor(_ownerId);
-    }
-    return _parentCache.lock();
+    // handle lookup is cheap, no need to cache, stale owner returns null
+    return _engine->getActorRegistry().getShared(_ownerId);
 }
 
 Component::~Component() = default;
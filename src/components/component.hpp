@@ -1,6 +1,9 @@
 #pragma once
 
 #include "utils/common.hpp"
+#include "core/scene/actor_registry.hpp"
+#include "components/component_type.hpp"
+#include "core/scene/update_tier.hpp"
 
 // components is unaware of owner actor
 // actor should be responsible for linking / unreferencing components
@@ -9,11 +12,13 @@ namespace luna {
 
 class Actor;
 class Engine;
+class ComponentPoolBase;
 
 class Component {
     public:
         // (the lower the update order, the earlier the component updates)
-        explicit Component(std::shared_ptr<Engine> engine, int ownerId, int updateOrder = 100);
+        explicit Component(std::shared_ptr<Engine> engine, ActorHandle ownerId,
+                           int updateOrder = 100);
         virtual ~Component();
 
         // calculate new state
@@ -21,24 +26,47 @@ class Component {
         // post update happens when all actor update and components are processed, should only push
         // result and not calculate new result
         virtual void postUpdate() {};
+        // once per rendered frame, push interpolated state (alpha between previous and current step)
+        virtual void preRender(float alpha) {};
         virtual void processInput(const struct InputState& keyState) {};
+        // owner world or interpolated transform changed this frame, called before preRender
+        virtual void transformChanged() {};
 
         // Getter
         [[nodiscard]] std::shared_ptr<Actor> getOwner();
+        [[nodiscard]] ActorHandle getOwnerId() const { return _ownerId; }
         [[nodiscard]] std::shared_ptr<Engine>& getEngine() { return _engine; };
         [[nodiscard]] int getUpdateOrder() const { return _updateOrder; }
         [[nodiscard]] bool getEnabled() const { return _enable; }
+        [[nodiscard]] ComponentTypeId getTypeId() const { return _typeId; }
+        [[nodiscard]] bool isPooled() const { return _pooled; }
+        [[nodiscard]] bool isTickEnabled() const { return _tickEnabled; }
+        [[nodiscard]] bool isOwnerActive() const { return _ownerActive; }
 
         // Setter
         void setEnable(bool enable) { _enable = enable; }
+        // opt in/out of update, postUpdate, preRender and input passes, idle component should
+        // turn it off so it costs nothing per frame
+        void setTickEnabled(bool tick);
 
         bool operator<(const Component& rhs) const;
 
     private:
+        friend class Actor;  // assigns type id and owner state
+        template <class T>
+        friend class ComponentPool;
+        friend class ComponentPools;  // runs unpooled update at owner tier
+
         bool _enable = true;
-        std::weak_ptr<Actor> _parentCache;
+        bool _ownerActive = true;  // mirrors owner EActive so pooled pass can skip without lookup
+        bool _pooled = false;      // updated by its pool pass, not by owner
+        bool _tickEnabled = true;
+        ComponentPoolBase* _pool = nullptr;
+        uint32_t _poolSlot = 0;
+        ComponentTypeId _typeId = MAX_COMPONENT_TYPES;
+        UpdateTierState _tier;  // mirrors owner update tier
         std::shared_ptr<Engine> _engine;
-        int _ownerId = -1;
+        ActorHandle _ownerId = INVALID_ACTOR_HANDLE;
         int _updateOrder;
 };
 
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "utils/common.hpp"
+
+// Component type id, fixed at compile time, each concrete class exposes its entry as TypeId
+// actor keeps a table indexed by it so typed lookup needs no rtti
+
+namespace luna {
+
+using ComponentTypeId = uint32_t;
+using ComponentMask = uint32_t;
+
+constexpr ComponentTypeId MAX_COMPONENT_TYPES = 32;  // bit count of ComponentMask
+
+// new component class appends an entry here
+enum ComponentType : ComponentTypeId {
+    EComponentMesh,
+    EComponentMove,
+    EComponentAnimation,
+    EComponentTween,
+    EComponentRigidBody,
+    EComponentLoader,
+    EComponentTypeCount
+};
+static_assert(EComponentTypeCount <= MAX_COMPONENT_TYPES, "component types exceed mask bits");
+
+template <class T>
+constexpr ComponentTypeId componentTypeId() {
+    static_assert(T::TypeId < MAX_COMPONENT_TYPES, "component type id exceeds mask bits");
+    return T::TypeId;
+}
+
+template <class T>
+constexpr ComponentMask componentBit() {
+    return ComponentMask{1} << componentTypeId<T>();
+}
+
+}  // namespace luna
@@ -5,7 +5,7 @@
 
 namespace luna {
 
-MoveComponent::MoveComponent(const std::shared_ptr<Engine> &engine, int ownerId)
+MoveComponent::MoveComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId)
     : Component(engine, ownerId) {}
 
 void MoveComponent::update(float deltaTime) {
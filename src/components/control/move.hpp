@@ -6,7 +6,9 @@ namespace luna {
 
 class MoveComponent : public Component {
     public:
-        explicit MoveComponent(const std::shared_ptr<Engine> &engine, int ownerId);
+        static constexpr ComponentTypeId TypeId = EComponentMove;
+
+        explicit MoveComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId);
 
         void update(float deltaTime) override;
 
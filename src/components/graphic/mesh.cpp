@@ -4,23 +4,30 @@
 #include "core/engine.hpp"
 #include "actors/actor.hpp"
 #include "core/renderer/renderer.hpp"
+#include "core/renderer/mesh_cache.hpp"
 #include "mesh.hpp"
 #include "utils/algo.hpp"
 
 namespace luna {
 
-MeshComponent::MeshComponent(const std::shared_ptr<Engine> &engine, int ownerId)
-    : Component(engine, ownerId) {}
+MeshComponent::MeshComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId)
+    : Component(engine, ownerId) {
+    setTickEnabled(false);
+}
 
 MeshComponent::~MeshComponent() {
     if (_modelState != nullptr) {
         getEngine()->getRenderer()->removeModal(_modelState);
     }
+    if (_bvhProxy != DynamicBvh::NULL_NODE) {
+        getEngine()->getSpatialIndex().destroyProxy(_bvhProxy);
+    }
 }
 
-void MeshComponent::postUpdate() {
+void MeshComponent::transformChanged() {
     if (_modelState != nullptr) {
-        _modelState->worldTransform = getOwner()->getWorldTransform();
+        _modelState->worldTransform = getOwner()->getInterpolatedWorldTransform();
+        getEngine()->getSpatialIndex().moveProxy(_bvhProxy, worldBounds());
     }
 }
 
@@ -79,7 +86,7 @@ void MeshComponent::loadObj(const std::string &path, const glm::vec3 &upAxis) {
             stbi_uc *data =
                 stbi_load(mat.normal_texname.c_str(), &matCpu.normalTexture.texWidth,
                           &matCpu.normalTexture.texHeight, &matCpu.normalTexture.texChannels, 4);
-            matCpu.albedoTexture.data = data;
+            matCpu.normalTexture.data = data;
             matCpu.normalTexture.texChannels = 4;
             if (!matCpu.normalTexture.data) {
                 l->error(
@@ -485,10 +492,38 @@ void MeshComponent::recurParseGlb(int nodeIdx, const tinygltf::Model &modal,
     }
 }
 
+bool MeshComponent::useCachedMesh(const std::string &key) {
+    _mesh = getEngine()->getMeshCache().find(key);
+    _cacheKey = _mesh == nullptr ? key : "";
+    return _mesh != nullptr;
+}
+
+void MeshComponent::loadSource(const MeshSource &source) {
+    switch (source.kind) {
+        case EMeshSourceModel:
+            loadModal(source.path, source.upAxis);
+            break;
+        case EMeshSourcePlane:
+            generateSquarePlane(source.size, source.color);
+            break;
+        case EMeshSourceSphere:
+            generateSphere(source.size, source.horizontalLine, source.verticalLine,
+                           source.color);
+            break;
+        default:
+            break;
+    }
+}
+
 void MeshComponent::loadModal(const std::string &path, const glm::vec3 &upAxis) {
     // Something to optimise
     // 1. remove redundant code into function, material etc
     // 2.
+    _source = {.kind = EMeshSourceModel, .path = path, .upAxis = upAxis};
+    if (useCachedMesh(fmt::format("{:s}|{:.3f},{:.3f},{:.3f}", path, upAxis.x, upAxis.y,
+                                  upAxis.z))) {
+        return;
+    }
     if (path.ends_with(".obj")) {
         loadObj(path, upAxis);
     } else if (path.ends_with(".glb")) {
@@ -533,6 +568,11 @@ void MeshComponent::generateTangentBitangent(int v0Idx, int v1Idx, int v2Idx) {
 }
 
 void MeshComponent::generateSquarePlane(float sideLength, const glm::vec3 &color) {
+    _source = {.kind = EMeshSourcePlane, .color = color, .size = sideLength};
+    if (useCachedMesh(fmt::format("@plane|{:.3f}|{:.3f},{:.3f},{:.3f}", sideLength, color.x,
+                                  color.y, color.z))) {
+        return;
+    }
     // generate square plane facing upward
     float hs = sideLength / 2;
     // pos, normal, tex, tangent, bitangent
@@ -553,6 +593,15 @@ void MeshComponent::generateSquarePlane(float sideLength, const glm::vec3 &color
 
 void MeshComponent::generateSphere(float radius, int horizontalLine, int verticalLine,
                                    const glm::vec3 &color) {
+    _source = {.kind = EMeshSourceSphere,
+               .color = color,
+               .size = radius,
+               .horizontalLine = horizontalLine,
+               .verticalLine = verticalLine};
+    if (useCachedMesh(fmt::format("@sphere|{:.3f}|{:d}|{:d}|{:.3f},{:.3f},{:.3f}", radius,
+                                  horizontalLine, verticalLine, color.x, color.y, color.z))) {
+        return;
+    }
     // https://stackoverflow.com/questions/4081898/procedurally-generate-a-sphere-mesh
     // generate all vertices
     for (int vi = 0; vi < verticalLine; ++vi) {
@@ -597,16 +646,33 @@ int MeshComponent::createDefaultMat(const glm::vec3 &color) {
 
 void MeshComponent::uploadToGpu() {
     auto l = SLog::get();
+    const auto &renderer = getEngine()->getRenderer();
 
-    // Upload to GPU
-    _modelState = getEngine()->getRenderer()->uploadModel(_modelData);
+    // Upload to GPU, only the first component of a source does real work
+    if (_mesh == nullptr) {
+        _mesh = renderer->uploadMesh(_modelData);
+        if (_mesh != nullptr && !_cacheKey.empty()) {
+            getEngine()->getMeshCache().insert(_cacheKey, _mesh);
+        }
+    }
+    DynamicBvh &spatial = getEngine()->getSpatialIndex();
+    if (_modelState != nullptr) {
+        renderer->removeModal(_modelState);
+        spatial.destroyProxy(_bvhProxy);
+        _bvhProxy = DynamicBvh::NULL_NODE;
+    }
+    _modelState = renderer->addModal(_mesh);
     if (_modelState == nullptr) {
         l->error("failed to upload modal data to gpu");
+    } else {
+        // owner may never move again, seed the transform once
+        _modelState->worldTransform = getOwner()->getWorldTransform();
+        _bvhProxy = spatial.createProxy(worldBounds(), getOwnerId(), _modelState.get(),
+                                        ESpatialMesh);
     }
 
-    //    // TODO: free local resource
-    //    stbi_image_free(_modelData.albedoTexture.stbRef);
-    //    stbi_image_free(_modelData.normalTexture.stbRef);
+    // gpu holds the data now
+    _modelData = {};
 }
 
 }  // namespace luna
\ No newline at end of file
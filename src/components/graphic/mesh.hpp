@@ -4,27 +4,58 @@
 
 #include "components/component.hpp"
 #include "core/renderer/def.hpp"
+#include "core/scene/dynamic_bvh.hpp"
 
 // store mesh information, materials
 
 namespace luna {
 
+enum MeshSourceKind { EMeshSourceNone, EMeshSourceModel, EMeshSourcePlane, EMeshSourceSphere };
+
+// how a mesh was made, enough to make it again (prefab, scene export)
+struct MeshSource {
+        MeshSourceKind kind = EMeshSourceNone;
+        std::string path;
+        glm::vec3 upAxis{0, 1, 0};
+        glm::vec3 color{};
+        float size = 0;  // plane side length or sphere radius
+        int horizontalLine = 0;
+        int verticalLine = 0;
+};
+
 class MeshComponent : public Component {
     public:
-        explicit MeshComponent(const std::shared_ptr<Engine> &engine, int ownerId);
+        static constexpr ComponentTypeId TypeId = EComponentMesh;
+
+        explicit MeshComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId);
         ~MeshComponent() override;
 
-        void postUpdate() override;
+        // no per frame tick, world transform and bounds are pushed only when owner moved
+        void transformChanged() override;
 
         // TODO: right now be like  this
         // can either load modal or procedurally generate one
+        // same source as an earlier mesh reuses its gpu mesh from engine mesh cache
         void loadModal(const std::string &path, const glm::vec3 &upAxis = glm::vec3{0, 1, 0});
         void generateSquarePlane(float sideLength, const glm::vec3 &color = glm::vec3{0, 0.1, 0.9});
         void generateSphere(float radius, int horizontalLine, int verticalLine,
                             const glm::vec3 &color = glm::vec3{0.3, 0.8, 0.1});
+        // dispatch to one of the above
+        void loadSource(const MeshSource &source);
+        // draw an already uploaded mesh made from source, skips loading
+        void setMesh(const std::shared_ptr<MeshGpu> &mesh, const MeshSource &source) {
+            _mesh = mesh;
+            _source = source;
+        }
+        // upload (unless shared) and start drawing, cpu side model data is released
         void uploadToGpu();
 
+        [[nodiscard]] const std::shared_ptr<MeshGpu> &getMesh() const { return _mesh; }
+        [[nodiscard]] const MeshSource &getSource() const { return _source; }
+
     private:
+        // true when the cache already has it, otherwise remember key for upload
+        bool useCachedMesh(const std::string &key);
         int createDefaultMat(const glm::vec3 &color);
         void generateTangentBitangent(int v0Idx, int v1Idx, int v2Idx);
 
@@ -34,9 +65,18 @@ class MeshComponent : public Component {
                            const std::vector<int> &gpuMatId, ModelDataPartition &partition,
                            const glm::mat4 &parentTransform);
 
+        [[nodiscard]] Aabb worldBounds() const {
+            return Aabb::transform({_mesh->boundsMin, _mesh->boundsMax},
+                                   _modelState->worldTransform);
+        }
+
         // Group model data based on material group
         ModelDataCpu _modelData;
+        MeshSource _source;
+        std::string _cacheKey;
+        std::shared_ptr<MeshGpu> _mesh;  // shared with every component of the same source
         std::shared_ptr<ModalState> _modelState;
+        int32_t _bvhProxy = DynamicBvh::NULL_NODE;  // world bounds while drawn
 };
 
 }  // namespace luna
\ No newline at end of file
@@ -13,8 +13,10 @@ namespace luna {
 
 // https://github.com/jrouwe/JoltPhysicsHelloWorld/blob/main/Source/HelloWorld.cpp
 
-RigidBodyComponent::RigidBodyComponent(const std::shared_ptr<Engine>& engine, int ownerId)
-    : Component(engine, ownerId) {}
+RigidBodyComponent::RigidBodyComponent(const std::shared_ptr<Engine>& engine, ActorHandle ownerId)
+    : Component(engine, ownerId) {
+    setTickEnabled(false);  // only a dynamic body needs to sync back every step
+}
 
 RigidBodyComponent::~RigidBodyComponent() {
     if (!_bodyId.IsInvalid()) {
@@ -43,11 +45,15 @@ void RigidBodyComponent::createBox(const glm::vec3& boxHalfExtentDim) {
         return;
     }
     JPH::ShapeRefC boxShapeRef = boxShapeRes.Get();
+    _shapeKind = EBodyShapeBox;
+    _shapeSize = boxHalfExtentDim;
     createShape(boxShapeRef);
 }
 
 void RigidBodyComponent::createSphere(float radius) {
     // shape setting (concise)
+    _shapeKind = EBodyShapeSphere;
+    _shapeSize = glm::vec3{radius, 0, 0};
     createShape(new JPH::SphereShape(radius));
 }
 
@@ -65,6 +71,7 @@ void RigidBodyComponent::createShape(const JPH::ShapeRefC& bodyShapeRef) {
         auto l = SLog::get();
         l->error("Create rigidbody returns invalid body id, possibly out of MAX collisions body");
     }
+    setTickEnabled(!_isStatic && !_bodyId.IsInvalid());
 }
 
 void RigidBodyComponent::setLinearVelocity(const glm::vec3& velo) {
@@ -8,9 +8,13 @@
 
 namespace luna {
 
+enum BodyShapeKind { EBodyShapeNone, EBodyShapeBox, EBodyShapeSphere };
+
 class RigidBodyComponent : public Component {
     public:
-        explicit RigidBodyComponent(const std::shared_ptr<Engine>& engine, int ownerId);
+        static constexpr ComponentTypeId TypeId = EComponentRigidBody;
+
+        explicit RigidBodyComponent(const std::shared_ptr<Engine>& engine, ActorHandle ownerId);
         ~RigidBodyComponent() override;
 
         void postUpdate() override;
@@ -27,6 +31,13 @@ class RigidBodyComponent : public Component {
         // modify body properties
         void setLinearVelocity(const glm::vec3& velo);
 
+        // Getter, creation parameters kept for scene export
+        [[nodiscard]] bool getIsStatic() const { return _isStatic; }
+        [[nodiscard]] float getBounciness() const { return _bounciness; }
+        [[nodiscard]] glm::vec3 getRelativePos() const { return _relPos; }
+        [[nodiscard]] BodyShapeKind getShapeKind() const { return _shapeKind; }
+        [[nodiscard]] glm::vec3 getShapeSize() const { return _shapeSize; }
+
     private:
         void createShape(const JPH::ShapeRefC& bodyShapeRef);
 
@@ -46,6 +57,8 @@ class RigidBodyComponent : public Component {
         // property
         glm::vec3 _relPos{};
         float _bounciness = 0;  // [0,1]
+        BodyShapeKind _shapeKind = EBodyShapeNone;
+        glm::vec3 _shapeSize{};  // box half extent, or radius in x
 
         JPH::BodyID _bodyId;
 };
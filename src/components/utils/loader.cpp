@@ -4,7 +4,7 @@
 
 #include "loader.hpp"
 
-luna::LoaderComponent::LoaderComponent(const std::shared_ptr<Engine> &engine, int ownerId)
+luna::LoaderComponent::LoaderComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId)
     : Component(engine, ownerId) {}
 
 luna::LoaderComponent::~LoaderComponent() {}
@@ -9,7 +9,9 @@ namespace luna {
 
 class LoaderComponent : public Component {
     public:
-        explicit LoaderComponent(const std::shared_ptr<Engine> &engine, int ownerId);
+        static constexpr ComponentTypeId TypeId = EComponentLoader;
+
+        explicit LoaderComponent(const std::shared_ptr<Engine> &engine, ActorHandle ownerId);
         ~LoaderComponent() override;
 
         void loadModal(const std::string &path, const glm::vec3 &upAxis = glm::vec3{0, 1, 0});
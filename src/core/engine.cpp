@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <SDL3/SDL.h>
 #include <backends/imgui_impl_sdl3.h>
 
@@ -5,7 +9,14 @@
 #include "core/input/input_system.hpp"
 #include "core/physic/physic.hpp"
 #include "core/renderer/renderer.hpp"
+#include "core/renderer/mesh_cache.hpp"
 #include "core/scripting/lua.hpp"
+#include "core/scene/scene_file.hpp"
+#include "core/time/frame_pacer.hpp"
+#include "core/task/task_scheduler.hpp"
+#include "core/profile/profiler.hpp"
+#include "core/profile/perf_overlay.hpp"
+#include "core/profile/hierarchy_panel.hpp"
 #include "actors/actor.hpp"
 #include "actors/player/camera.hpp"
 #include "actors/object/static.hpp"
@@ -14,14 +25,43 @@
 #include "components/anim/tween.hpp"
 #include "components/graphic/mesh.hpp"
 #include "components/physic/rigidbody.hpp"
+#include "components/control/move.hpp"
 
 namespace luna {
-bool Engine::initialize(std::shared_ptr<Engine> &self) {
+
+constexpr int DEFAULT_PROFILE_FRAMES = 120;
+
+bool Engine::initialize(std::shared_ptr<Engine> &self, EngineConfig config) {
     _self = self;
+    _conf = std::move(config);
     auto l = SLog::get();
+    setSimulationRate(_conf.simulationHz);
+    Profiler::get()->setThreadName("Game");
+    _perfOverlay = std::make_shared<PerfOverlay>();
+    _hierarchyPanel = std::make_shared<HierarchyPanel>();
+    _meshCache = std::make_shared<MeshCache>();
+
+    // headless runs are for benchmarking, don't cap frame rate
+    FramePacerConfig pacerConf{};
+    if (_conf.headless) pacerConf.targetFps = 0;
+    _framePacer = std::make_shared<FramePacer>();
+    if (!_framePacer->initialise(pacerConf)) {
+        l->error("failed to initialise frame pacer");
+        return false;
+    }
 
+    _taskScheduler = std::make_shared<TaskScheduler>();
+    if (!_taskScheduler->initialise()) {
+        l->error("failed to initialise task scheduler");
+        return false;
+    }
+
+    RenderConfig renderConf{};
+    renderConf.headless = _conf.headless;
+    renderConf.stagingRingMb = static_cast<uint32_t>(std::max(_conf.stagingRingMb, 1));
+    renderConf.gpuDriven = _conf.gpuDriven;
     _renderer = std::make_shared<Renderer>();
-    if (!_renderer->initialise()) {  // TODO: custom config
+    if (!_renderer->initialise(renderConf)) {
         l->error("failed to initialise renderer");
         return false;
     }
@@ -30,9 +70,17 @@ bool Engine::initialize(std::shared_ptr<Engine> &self) {
         l->error("failed to initialise input system");
         return false;
     }
+    if (!_conf.replayInputPath.empty() && !_inputSystem->startReplay(_conf.replayInputPath)) {
+        l->error("failed to start input replay");
+        return false;
+    }
+    if (!_conf.recordInputPath.empty() && !_inputSystem->startRecording(_conf.recordInputPath)) {
+        l->error("failed to start input recording");
+        return false;
+    }
     PhysicSystem::preInit();
     _physicSystem = std::make_shared<PhysicSystem>();
-    if (!_physicSystem->initialise()) {
+    if (!_physicSystem->initialise(_taskScheduler.get())) {
         l->error("failed to initialise physic system");
         return false;
     }
@@ -42,20 +90,92 @@ bool Engine::initialize(std::shared_ptr<Engine> &self) {
         return false;
     }
 
+    // pooled component types, registration order is the order inside an update bucket
+    // EPoolParallel is for types that only write themselves and their owner transform, with at
+    // most one per actor, none of the current ones qualify (tweens stack, meshes don't tick)
+    _componentPools.setTaskScheduler(_taskScheduler.get());
+    _componentPools.registerPool<TweenComponent>("tweenSystem");
+    _componentPools.registerPool<MoveComponent>("moveSystem");
+    _componentPools.registerPool<MeshComponent>("meshSystem");
+    _componentPools.registerPool<RigidBodyComponent>("rigidBodySystem");
+
     if (!prepareScene()) {
         l->error("failed to prepare scene");
         return false;
     }
 
+    if (_conf.profileFrames > 0) {
+        Profiler::get()->beginCapture(_conf.profileFrames, _conf.profileOutputPath);
+    }
+
     return true;
 }
 
 void Engine::run() {
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    };
+
+    bool recordTiming = !_conf.timingOutputPath.empty();
+    if (recordTiming && _conf.frameCount > 0) _frameTimings.reserve(_conf.frameCount);
+
+    int frame = 0;
     while (_gameState != EQuit) {
-        processInput();
-        updateGame();
-        drawOutput();
+        if (_conf.frameCount > 0 && frame >= _conf.frameCount) break;
+
+        auto t0 = Clock::now();
+        {
+            PROFILE_SCOPE("waitFrame");
+            _framePacer->waitNextFrame();
+        }
+        auto t1 = Clock::now();
+        {
+            PROFILE_SCOPE("processInput");
+            processInput();
+        }
+        auto t2 = Clock::now();
+        {
+            PROFILE_SCOPE("updateGame");
+            updateGame();
+        }
+        auto t3 = Clock::now();
+        {
+            PROFILE_SCOPE("drawOutput");
+            drawOutput();
+        }
+        auto t4 = Clock::now();
+        Profiler::get()->endFrame();
+
+        _perfOverlay->recordFrame(
+            _framePacer->getRawDeltaTime() * 1000.0f,
+            {elapsedMs(t0, t1), elapsedMs(t1, t2), elapsedMs(t2, t3), elapsedMs(t3, t4)});
+        if (recordTiming) {
+            _frameTimings.push_back(
+                {elapsedMs(t0, t1), elapsedMs(t1, t2), elapsedMs(t2, t3), elapsedMs(t3, t4)});
+        }
+        frame++;
     }
+
+    if (recordTiming) writeTimingCsv(_conf.timingOutputPath);
+}
+
+bool Engine::writeTimingCsv(const std::string &path) const {
+    auto l = SLog::get();
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        l->error(fmt::format("failed to open timing output {:s}", path));
+        return false;
+    }
+    file << "frame,wait_ms,input_ms,update_ms,submit_ms,total_ms\n";
+    for (int i = 0; i < _frameTimings.size(); ++i) {
+        const FrameTiming &t = _frameTimings[i];
+        file << fmt::format("{:d},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f}\n", i, t.waitMs, t.inputMs,
+                            t.updateMs, t.submitMs,
+                            t.waitMs + t.inputMs + t.updateMs + t.submitMs);
+    }
+    l->info(fmt::format("wrote {:d} frame timings to {:s}", _frameTimings.size(), path));
+    return true;
 }
 
 Engine::~Engine() {
@@ -63,6 +183,8 @@ Engine::~Engine() {
     if (_inputSystem) _inputSystem->shutdown();
     if (_renderer) _renderer->shutdown();
     if (_physicSystem) _physicSystem->shutdown();
+    if (_framePacer) _framePacer->shutdown();
+    if (_taskScheduler) _taskScheduler->shutdown();
 };
 
 void Engine::processInput() {
@@ -71,26 +193,29 @@ void Engine::processInput() {
     // POLL for keyboard event
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
-        ImGui_ImplSDL3_ProcessEvent(&event);
+        if (!_conf.headless) ImGui_ImplSDL3_ProcessEvent(&event);
         switch (event.type) {
             case SDL_EVENT_QUIT:
                 _gameState = EQuit;
                 break;
             default:
-                _inputSystem->processEvent(event);
+                if (!_inputSystem->isReplaying()) _inputSystem->processEvent(event);
                 break;
         }
     }
 
-    _inputSystem->update();
+    _inputSystem->update(_framePacer->getDeltaTime());
+    if (_inputSystem->isReplayFinished()) {
+        _gameState = EQuit;
+        return;
+    }
     const InputState &state = _inputSystem->getState();
 
     // propagate input to global / actors / ui
     handleGlobalInput(state);
     if (_gameState == EGameplay) {
-        for (const auto &actorIter : _actorMap) {
-            actorIter.second->processInput(state);
-        }
+        _componentPools.processInput(state);
+        _inputList.forEach(_actorRegistry, [&state](Actor *a) { a->processInput(state); });
     }
 }
 
@@ -106,40 +231,70 @@ void Engine::updateGame() {
         }
     }
 
-    // Simple solution for frame limiting.
-    // Wait until 16ms has elapsed since last frame
-    Uint64 deadline = SDL_GetTicks() + 16;
-    while (SDL_GetTicks() < deadline);
-
-    // Get delta in second
-    uint64_t curTicks = SDL_GetTicks();
-    float deltaTime = static_cast<float>(curTicks - _tickCountMs) / 1000.0f;
-    _tickCountMs = curTicks;
-    _renderer->writeDebugUi(fmt::format("FPS:  {:d}", int(1.0f / deltaTime)));
-    //    _renderer->writeDebugUi(fmt::format("Draw: {:d}us", _lastDrawFrameTimeUs));  // TODO:
-    //    Benchmark each phase draw call time
-
-    // Clamp maximum delta to prevent huge delta time (ex, when stepping through debugger)
-    deltaTime = std::min(deltaTime, 0.05f);
+    // Delta time is paced and clamped by frame pacer, or comes from the input replay
+    float deltaTime = _inputSystem->getDeltaTime();
 
     // Only update in gameplay mode
     if (_gameState == EGameplay) {
-        // Update all existing actors
-        for (auto &actorIter : _actorMap) {
-            actorIter.second->update(deltaTime);
+        // gameplay and physic advance in fixed steps, render blends the last two steps
+        _simAccumS += deltaTime;
+        int steps = 0;
+        while (_simAccumS >= _simStepS && steps < _conf.maxSimStepsPerFrame) {
+            _transformSystem.savePreviousTransforms();
+            {
+                PROFILE_SCOPE("actorUpdate");
+                // component update buckets across every actor, then actor specific, then post
+                // only actors subscribed to tick are visited, unpooled component forces that
+                _unpooledScratch.clear();
+                _updateList.forEach(_actorRegistry, [this](Actor *a) {
+                    a->gatherUnpooledComponents(_unpooledScratch);
+                });
+                _componentPools.update(_simStepS, _simStepIdx, _unpooledScratch);
+                _updateList.forEach(_actorRegistry, [this](Actor *a) {
+                    a->tieredUpdate(_simStepIdx, _simStepS);
+                });
+                _componentPools.postUpdate();
+            }
+            {
+                PROFILE_SCOPE("physicStep");
+                _physicSystem->step(_simStepS);
+            }
+            _simAccumS -= _simStepS;
+            _simStepIdx++;
+            steps++;
+        }
+        if (_simAccumS >= _simStepS) {
+            float keepS = std::fmod(_simAccumS, _simStepS);
+            auto l = SLog::get();
+            l->warn(fmt::format("simulation falling behind, dropping {:.2f}ms",
+                                (_simAccumS - keepS) * 1000.0f));
+            _simAccumS = keepS;
         }
 
-        // update physic
-        _physicSystem->update(deltaTime);
+        // remove actors marked dead this frame
+        removeDeadActors();
 
-        // Check dead vector and remove
-        for (auto actorIter = _actorMap.begin(); actorIter != _actorMap.end();) {
-            if (actorIter->second->getState() == Actor::EDead) {
-                actorIter = _actorMap.erase(actorIter);
-            } else {
-                ++actorIter;
-            }
+        // resolve world transform of dirty subtrees once, then blend for rendering
+        float alpha = _simAccumS / _simStepS;
+        {
+            PROFILE_SCOPE("transformUpdate");
+            _transformSystem.update();
+            _transformSystem.interpolate(alpha);
+        }
+        {
+            PROFILE_SCOPE("updateTier");
+            assignUpdateTiers();
+        }
+
+        // push interpolated state for rendering, transform push only visits moved actors
+        PROFILE_SCOPE("preRender");
+        for (ActorHandle handle : _transformSystem.getChangedHandles()) {
+            Actor *actor = _actorRegistry.get(handle);
+            if (actor != nullptr) actor->transformChanged();
         }
+        _componentPools.preRender(alpha);
+        _preRenderList.forEach(_actorRegistry, [alpha](Actor *a) { a->preRender(alpha); });
+        cullScene();
     }
 }
 
@@ -147,52 +302,90 @@ void Engine::drawOutput() {
     // TODO: too crude, should consider ui frame
     if (_gameState != EGameplay) return;
     // new frame
-    _renderer->newFrame();
-    _renderer->beginRecordCmd();
-    _renderer->drawAllModel();
+    // build ui and publish snapshot, recording and submission happen on render thread
+    _renderer->newFrame(_framePacer->getDeltaTime());
     drawDebugUi();
-    _renderer->endRecordCmd();
-    _renderer->draw();
+    _renderer->submitFrame();
 }
 
 void Engine::drawDebugUi() {
-    if (ImGui::Begin("Engine##ActorHierarchy")) {
-        for (const auto &actorIter : _actorMap) {
-            // find root
-            if (actorIter.second->getParentId() == -1) {
-                drawDebugUiActorRecursive(actorIter.second);
-            }
-        }
-        ImGui::End();
+    _perfOverlay->draw(_renderer->getRenderStats());
+    _hierarchyPanel->draw(_actorRegistry);
+}
+
+ActorHandle Engine::addActor(const std::shared_ptr<Actor> &actor) {
+    ActorHandle handle = _actorRegistry.add(actor);
+    if (handle == INVALID_ACTOR_HANDLE) {
+        return handle;
     }
+    _transformSystem.add(handle);
+    _hierarchyPanel->actorAdded(handle);
+    actor->delayInit(handle, _self.lock());
+    return handle;
 }
 
-void Engine::drawDebugUiActorRecursive(const std::shared_ptr<Actor> &actor) {
-    ImGuiTreeNodeFlags initFlag = actor->getDebugUiExpand() ? ImGuiTreeNodeFlags_DefaultOpen : 0;
-    if (ImGui::TreeNodeEx(actor->debugDisplayName().c_str(), initFlag)) {
-        actor->setDebugUiExpand(true);
-        for (const auto &childId : actor->getChildrenIdList()) {
-            auto childActor = _actorMap.find(childId);
-            if (childActor == _actorMap.end()) {
-                SLog::get()->error(
-                    fmt::format("actor has child id {:d} but it is not found in engine!", childId));
-                return;
-            }
-            drawDebugUiActorRecursive(childActor->second);
-        }
-        ImGui::TreePop();
-    } else {
-        actor->setDebugUiExpand(false);
+void Engine::reserveActors(size_t count) {
+    _actorRegistry.reserve(count);
+    _transformSystem.reserve(count);
+}
+
+void Engine::updateActorTick(ActorHandle handle, uint32_t oldFlags, uint32_t newFlags) {
+    auto apply = [handle, oldFlags, newFlags](ActorTickList &list, uint32_t flag) {
+        if ((newFlags & flag) && !(oldFlags & flag)) list.add(handle);
+        if (!(newFlags & flag) && (oldFlags & flag)) list.remove(handle);
+    };
+    apply(_updateList, Actor::ETickUpdate);
+    apply(_inputList, Actor::ETickInput);
+    apply(_preRenderList, Actor::ETickPreRender);
+}
+
+void Engine::markActorDead(ActorHandle handle) { _deadActors.push_back(handle); }
+
+void Engine::actorParentChanged(ActorHandle handle, bool isRoot) {
+    _hierarchyPanel->parentChanged(handle, isRoot);
+}
+
+void Engine::removeDeadActors() {
+    for (ActorHandle handle : _deadActors) {
+        Actor *actor = _actorRegistry.get(handle);
+        if (actor == nullptr || actor->getState() != Actor::EDead) continue;
+        updateActorTick(handle, actor->getTickFlags(), Actor::ETickNone);
+        _hierarchyPanel->actorRemoved(*actor, _actorRegistry);
+        _transformSystem.remove(handle);
+        _actorRegistry.remove(handle);
     }
+    _deadActors.clear();
 }
 
-void Engine::addActor(const std::shared_ptr<Actor> &actor) {
-    _actorMap.emplace(_actorIdInc, actor);
-    actor->delayInit(_actorIdInc, _self.lock());
-    _actorIdInc++;
+void Engine::assignUpdateTiers() {
+    auto *cam = static_cast<CameraActor *>(_actorRegistry.get(_activeCamera));
+    const auto &actors = _actorRegistry.getActors();
+    if (cam == nullptr || actors.empty()) return;
+
+    glm::vec3 camPos = cam->getWorldPosition();
+    glm::mat4 viewProj = cam->getPerspectiveTransformMatrix() * cam->getCamViewTransform();
+    float ndcLimit = 1.0f + _tierConf.offscreenMargin;
+
+    // a slice of actors per frame, tier lagging a few frames behind the camera is fine
+    size_t count = std::min(actors.size(), static_cast<size_t>(_tierConf.actorsPerFrame));
+    for (size_t i = 0; i < count; i++) {
+        if (_tierCursor >= actors.size()) _tierCursor = 0;
+        Actor *actor = actors[_tierCursor++].get();
+        if (!actor->isAutoUpdateTier()) continue;
+
+        glm::vec3 pos = actor->getWorldPosition();
+        glm::vec4 clip = viewProj * glm::vec4(pos, 1);
+        bool visible = clip.w > 0 && std::abs(clip.x) <= ndcLimit * clip.w &&
+                       std::abs(clip.y) <= ndcLimit * clip.w;
+        actor->setUpdateTier(selectUpdateTier(glm::distance(pos, camPos), visible, _tierConf));
+    }
 }
 
 bool Engine::prepareScene() {
+    // baked scene skips lua entirely
+    if (!_conf.scenePath.empty()) {
+        return SceneFile::load(_self.lock(), _conf.scenePath);
+    }
     // rely on external lua script to setup scene
     // flexible!
     if (!_scriptSystem->execScriptFile("assets/scene/scene.lua")) {
@@ -244,15 +437,84 @@ bool Engine::prepareScene() {
     return true;
 }
 
+void Engine::cullScene() {
+    PROFILE_SCOPE("cull");
+    auto *cam = static_cast<CameraActor *>(_actorRegistry.get(_activeCamera));
+    _lightScratch.clear();
+    if (cam == nullptr) {
+        // nothing to cull against, draw every instance and the first lights
+        _renderer->setCullStamp(0);
+        _spatialIndex.forEach(ESpatialLight, [this](int32_t proxy) {
+            auto *light = static_cast<PointLightActor *>(_spatialIndex.getUserData(proxy));
+            _lightScratch.emplace_back(0.0f, light);
+            return _lightScratch.size() < MAX_POINT_LIGHTS;
+        });
+    } else {
+        Frustum frustum = Frustum::fromMatrix(cam->getPerspectiveTransformMatrix() *
+                                              cam->getCamViewTransform());
+        if (_renderer->isGpuDriven()) {
+            // cull.comp tests every instance, snapshot has to carry all of them
+            _renderer->setCullStamp(0);
+        } else {
+            // visible instances get this frame stamp, renderer skips the rest
+            _renderer->setCullStamp(++_cullStamp);
+            _spatialIndex.queryFrustum(frustum, ESpatialMesh, [this](int32_t proxy) {
+                auto *modalState = static_cast<ModalState *>(_spatialIndex.getUserData(proxy));
+                modalState->visibleStamp = _cullStamp;
+                return true;
+            });
+        }
+        // lights reaching into the view, closest first
+        glm::vec3 camPos = cam->getWorldPosition();
+        _spatialIndex.queryFrustum(frustum, ESpatialLight, [this, &camPos](int32_t proxy) {
+            auto *light = static_cast<PointLightActor *>(_spatialIndex.getUserData(proxy));
+            glm::vec3 toLight = light->getLightPosition() - camPos;
+            _lightScratch.emplace_back(glm::dot(toLight, toLight), light);
+            return true;
+        });
+        size_t keep = std::min(_lightScratch.size(), static_cast<size_t>(MAX_POINT_LIGHTS));
+        std::partial_sort(_lightScratch.begin(), _lightScratch.begin() + keep, _lightScratch.end(),
+                          [](const auto &a, const auto &b) { return a.first < b.first; });
+        _lightScratch.resize(keep);
+    }
+    for (const auto &[dist, light] : _lightScratch) {
+        _renderer->setLightInfo(light->getLightPosition(), light->getColor(), light->getRadius());
+    }
+}
+
 void Engine::destroyScene() {
     auto l = SLog::get();
     _scriptSystem->gc();  // important to release unused reference
-    l->info(fmt::format("destroying scene: actor count {:d}", _actorMap.size()));
-    for (const auto &pair : _actorMap) {
-        l->info(fmt::format("{:s} reference {:d}", pair.second->displayName(),
-                            pair.second.use_count()));
+    l->info(fmt::format("destroying scene: actor count {:d}", _actorRegistry.size()));
+    // only actors still referenced elsewhere (script, component) are worth a line
+    for (const auto &actor : _actorRegistry.getActors()) {
+        if (actor.use_count() > 1) {
+            l->info(fmt::format("{:s} reference {:d}", actor->displayName(), actor.use_count()));
+        }
     }
-    _actorMap.clear();
+    // blocks go back to the arena free lists, chunks are kept for the next scene
+    _actorRegistry.clear();
+    _transformSystem.clear();
+    _updateList.clear();
+    _inputList.clear();
+    _preRenderList.clear();
+    _deadActors.clear();
+    _hierarchyPanel->clear();
+    // meshes no longer drawn are released by renderer on next submit
+    _meshCache->clear();
+    l->info(fmt::format("arena after destroy: actor {:d} live, component {:d} live",
+                        _actorArena.liveCount(), _componentPools.getArena().liveCount()));
+    // proxies go with their mesh / light, what is left is still referenced by script
+    if (_spatialIndex.size() > 0) {
+        l->info(fmt::format("spatial index after destroy: {:d} proxies", _spatialIndex.size()));
+    }
+    _activeCamera = INVALID_ACTOR_HANDLE;
+    _tierCursor = 0;
+}
+
+void Engine::setSimulationRate(int hz) {
+    _conf.simulationHz = std::max(1, hz);
+    _simStepS = 1.0f / static_cast<float>(_conf.simulationHz);
 }
 
 void Engine::handleGlobalInput(const InputState &key) {
@@ -266,5 +528,15 @@ void Engine::handleGlobalInput(const InputState &key) {
         l->info("detected reload key, rebuilding world from script");
         _gameState = EReload;
     }
+    if (key.Keyboard.getKeyState(SDL_SCANCODE_F3) == EPressed) {
+        _perfOverlay->toggleVisible();
+    }
+    if (key.Keyboard.getKeyState(SDL_SCANCODE_F4) == EPressed) {
+        _hierarchyPanel->toggleVisible();
+    }
+    if (key.Keyboard.getKeyState(SDL_SCANCODE_F9) == EPressed) {
+        int frames = _conf.profileFrames > 0 ? _conf.profileFrames : DEFAULT_PROFILE_FRAMES;
+        Profiler::get()->beginCapture(frames, _conf.profileOutputPath);
+    }
 }
 }  // namespace luna
\ No newline at end of file
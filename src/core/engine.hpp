@@ -1,8 +1,13 @@
 #pragma once
 
-#include <unordered_map>
-
 #include "core/input/input_system.hpp"
+#include "core/scene/actor_registry.hpp"
+#include "core/scene/transform_system.hpp"
+#include "core/scene/component_pool.hpp"
+#include "core/scene/tick_list.hpp"
+#include "core/scene/update_tier.hpp"
+#include "core/scene/object_arena.hpp"
+#include "core/scene/dynamic_bvh.hpp"
 #include "utils/common.hpp"
 
 namespace luna {
@@ -11,17 +16,40 @@ class RenderConfig;
 class InputSystem;
 class PhysicSystem;
 class ScriptingSystem;
+class FramePacer;
+class TaskScheduler;
+class PerfOverlay;
+class HierarchyPanel;
+class MeshCache;
 class Actor;
+class Component;
 class CameraActor;
 class StaticActor;
+class PointLightActor;
+
+struct EngineConfig {
+        bool headless = false;         // offscreen rendering, no window or present
+        int frameCount = 0;            // stop after n frames, <= 0 runs until quit
+        std::string timingOutputPath;  // per frame phase timing csv, empty to disable
+        int simulationHz = 60;         // fixed gameplay and physic step rate
+        int maxSimStepsPerFrame = 4;   // drop simulation time past this instead of spiraling
+        std::string recordInputPath;   // record input and frame delta time to file
+        std::string replayInputPath;   // replay recorded input instead of SDL, quit when done
+        int profileFrames = 0;         // capture n frames from start, also used by F9 hotkey
+        std::string profileOutputPath = "profile_trace.json";
+        std::string scenePath;         // binary scene to load instead of the scene script
+        int stagingRingMb = 64;        // upload staging ring size
+        bool gpuDriven = true;         // compute culled indirect draws when the gpu supports it
+};
 
 class Engine {
     public:
         Engine() = default;
         virtual ~Engine();
 
-        bool initialize(std::shared_ptr<Engine>& self);
+        bool initialize(std::shared_ptr<Engine>& self, EngineConfig config = {});
         void run();
+        bool writeTimingCsv(const std::string& path) const;
 
         bool prepareScene();
         void destroyScene();
@@ -29,39 +57,98 @@ class Engine {
         void updateGame();
         void drawOutput();
         void drawDebugUi();
-        void drawDebugUiActorRecursive(const std::shared_ptr<Actor>& actor);
         void handleGlobalInput(const InputState& key);
+        void setSimulationRate(int hz);
+        void removeDeadActors();
+        void assignUpdateTiers();
+        // frustum cull mesh instances and pick the point lights sent to renderer
+        void cullScene();
 
         enum GameState { EGameplay, EReload, EPaused, EQuit };
 
-        // Create or delete actors
-        void addActor(const std::shared_ptr<Actor>& actor);
-        std::shared_ptr<Actor> getActor(int actorId) {
-            auto iter = _actorMap.find(actorId);
-            return iter == _actorMap.end() ? nullptr : iter->second;
+        // time spent in each phase of a frame, in ms
+        struct FrameTiming {
+                float waitMs;
+                float inputMs;
+                float updateMs;
+                float submitMs;  // ui build and snapshot handoff, render thread runs apart
         };
 
+        // Create or delete actors
+        ActorHandle addActor(const std::shared_ptr<Actor>& actor);
+        // allocate from the actor arena and add, nullptr when the registry is full
+        template <class T, class... Args>
+        std::shared_ptr<T> createActor(Args&&... args) {
+            auto actor = std::allocate_shared<T>(ArenaAllocator<T>(&_actorArena),
+                                                 std::forward<Args>(args)...);
+            if (addActor(actor) == INVALID_ACTOR_HANDLE) return nullptr;
+            return actor;
+        }
+        // grow actor storage once before a bulk spawn
+        void reserveActors(size_t count);
+        // (un)subscribe actor from per frame update / input / preRender lists
+        void updateActorTick(ActorHandle handle, uint32_t oldFlags, uint32_t newFlags);
+        // removed at the end of the simulation steps of this frame
+        void markActorDead(ActorHandle handle);
+        // nullptr when handle is stale (actor removed) or invalid
+        std::shared_ptr<Actor> getActor(ActorHandle handle) {
+            return _actorRegistry.getShared(handle);
+        }
+        // keep debug hierarchy root list in sync, called by actor after reparent
+        void actorParentChanged(ActorHandle handle, bool isRoot);
+        // camera used for update tier distance and visibility
+        void setActiveCamera(ActorHandle handle) { _activeCamera = handle; }
+        const ActorRegistry& getActorRegistry() const { return _actorRegistry; }
+        TransformSystem& getTransformSystem() { return _transformSystem; }
+        ComponentPools& getComponentPools() { return _componentPools; }
+        // world bounds of meshes and lights, proxies are owned by the component / actor
+        DynamicBvh& getSpatialIndex() { return _spatialIndex; }
+
         // Core Getter accessed by subsystem
         std::shared_ptr<Renderer> getRenderer() { return _renderer; }
         std::shared_ptr<InputSystem> getInputSystem() { return _inputSystem; }
         std::shared_ptr<PhysicSystem> getPhysicSystem() { return _physicSystem; }
+        std::shared_ptr<FramePacer> getFramePacer() { return _framePacer; }
+        std::shared_ptr<TaskScheduler> getTaskScheduler() { return _taskScheduler; }
+        MeshCache& getMeshCache() { return *_meshCache; }
 
     private:
         std::weak_ptr<Engine> _self;
+        EngineConfig _conf;
         GameState _gameState = EGameplay;
-        uint64_t _tickCountMs = 0;
-        uint64_t _lastDrawFrameTimeUs = 0;
-        int _actorIdInc = 0;
+        float _simStepS = 1.0f / 60.0f;
+        float _simAccumS = 0;
+        uint64_t _simStepIdx = 0;
+        std::vector<FrameTiming> _frameTimings;
 
         // System
         std::shared_ptr<Renderer> _renderer = nullptr;
         std::shared_ptr<InputSystem> _inputSystem = nullptr;
         std::shared_ptr<PhysicSystem> _physicSystem = nullptr;
         std::shared_ptr<ScriptingSystem> _scriptSystem = nullptr;
+        std::shared_ptr<FramePacer> _framePacer = nullptr;
+        std::shared_ptr<TaskScheduler> _taskScheduler = nullptr;
+        std::shared_ptr<PerfOverlay> _perfOverlay = nullptr;
+        std::shared_ptr<HierarchyPanel> _hierarchyPanel = nullptr;
+        std::shared_ptr<MeshCache> _meshCache = nullptr;
 
         // game specific member
         // TODO: refactor to game/scene class
-        std::unordered_map<int, std::shared_ptr<Actor>> _actorMap;
-        std::shared_ptr<CameraActor> _camActor = nullptr;
+        // arena and pools declared first so they outlive actors holding pooled components
+        ObjectArena _actorArena{"actorArena"};
+        DynamicBvh _spatialIndex;
+        ComponentPools _componentPools;
+        std::vector<Component*> _unpooledScratch;
+        ActorRegistry _actorRegistry;
+        TransformSystem _transformSystem;
+        ActorTickList _updateList;
+        ActorTickList _inputList;
+        ActorTickList _preRenderList;
+        std::vector<ActorHandle> _deadActors;
+        ActorHandle _activeCamera = INVALID_ACTOR_HANDLE;
+        UpdateTierConfig _tierConf;
+        size_t _tierCursor = 0;  // round robin position of tier assignment
+        uint64_t _cullStamp = 0;
+        std::vector<std::pair<float, PointLightActor*>> _lightScratch;
 };
 }  // namespace luna
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <cstring>
+
+#include "input_record.hpp"
+
+namespace luna {
+
+constexpr uint8_t FRAME_FLAG_KEYBOARD = 0b1;
+constexpr uint8_t FRAME_FLAG_CONTROLLER = 0b10;
+constexpr int KEY_BITSET_BYTES = (SDL_SCANCODE_COUNT + 7) / 8;
+constexpr int GAMEPAD_BITSET_BYTES = (SDL_GAMEPAD_BUTTON_COUNT + 7) / 8;
+
+template <class T>
+static void writePod(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+bool InputRecorder::open(const std::string &path) {
+    auto l = SLog::get();
+    _file.open(path, std::ios::binary | std::ios::trunc);
+    if (!_file.is_open()) {
+        l->error(fmt::format("failed to open input record file {:s}", path));
+        return false;
+    }
+    _frameCount = 0;
+    _hasLastKeys = false;
+    writePod(_file, INPUT_RECORD_MAGIC);
+    writePod(_file, INPUT_RECORD_VERSION);
+    writePod(_file, _frameCount);  // patched on close
+    l->info(fmt::format("recording input to {:s}", path));
+    return true;
+}
+
+void InputRecorder::close() {
+    if (!_file.is_open()) return;
+    _file.seekp(sizeof(INPUT_RECORD_MAGIC) + sizeof(INPUT_RECORD_VERSION));
+    writePod(_file, _frameCount);
+    _file.close();
+    SLog::get()->info(fmt::format("recorded {:d} input frames", _frameCount));
+}
+
+void InputRecorder::capture(const InputState &state, float deltaTime) {
+    if (!_file.is_open()) return;
+
+    // keyboard rarely changes between frames, only store it on change
+    const KeyboardState &keyboard = state.Keyboard;
+    bool keyChanged = !_hasLastKeys;
+    for (int i = 0; i < SDL_SCANCODE_COUNT && !keyChanged; ++i) {
+        keyChanged = _lastKeys[i] != keyboard._curState[i];
+    }
+
+    const ControllerState &controller = state.Controller;
+    uint8_t flags = 0;
+    if (keyChanged) flags |= FRAME_FLAG_KEYBOARD;
+    if (controller._isConnected) flags |= FRAME_FLAG_CONTROLLER;
+
+    writePod(_file, deltaTime);
+    writePod(_file, flags);
+
+    if (keyChanged) {
+        uint8_t bitset[KEY_BITSET_BYTES]{};
+        for (int i = 0; i < SDL_SCANCODE_COUNT; ++i) {
+            _lastKeys[i] = keyboard._curState[i];
+            if (_lastKeys[i]) bitset[i / 8] |= 1 << (i % 8);
+        }
+        _hasLastKeys = true;
+        _file.write(reinterpret_cast<const char *>(bitset), KEY_BITSET_BYTES);
+    }
+
+    const MouseState &mouse = state.Mouse;
+    writePod(_file, mouse._curButtons);
+    writePod(_file, mouse._mousePos);
+    writePod(_file, mouse._mouseOffsetPos);
+    writePod(_file, mouse._scrollWheel);
+    writePod(_file, static_cast<uint8_t>(mouse._isRelative));
+
+    if (controller._isConnected) {
+        uint8_t bitset[GAMEPAD_BITSET_BYTES]{};
+        for (int i = 0; i < SDL_GAMEPAD_BUTTON_COUNT; ++i) {
+            if (controller._curButtons[i]) bitset[i / 8] |= 1 << (i % 8);
+        }
+        _file.write(reinterpret_cast<const char *>(bitset), GAMEPAD_BITSET_BYTES);
+        writePod(_file, controller._leftStick);
+        writePod(_file, controller._rightStick);
+        writePod(_file, controller._leftTrigger);
+        writePod(_file, controller._rightTrigger);
+    }
+
+    _frameCount++;
+}
+
+bool InputPlayer::open(const std::string &path) {
+    auto l = SLog::get();
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        l->error(fmt::format("failed to open input replay file {:s}", path));
+        return false;
+    }
+    _data.resize(file.tellg());
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(_data.data()), static_cast<std::streamsize>(_data.size()));
+    _cursor = 0;
+
+    uint32_t magic = 0, version = 0;
+    if (!read(magic) || !read(version) || !read(_frameCount) || magic != INPUT_RECORD_MAGIC) {
+        l->error(fmt::format("{:s} is not an input recording", path));
+        return false;
+    }
+    if (version != INPUT_RECORD_VERSION) {
+        l->error(fmt::format("unsupported input recording version {:d}", version));
+        return false;
+    }
+    l->info(fmt::format("replaying {:d} input frames from {:s}", _frameCount, path));
+    return true;
+}
+
+bool InputPlayer::next(InputState &state, float &outDeltaTime) {
+    uint8_t flags = 0;
+    if (!read(outDeltaTime) || !read(flags)) return false;
+
+    KeyboardState &keyboard = state.Keyboard;
+    keyboard._curState = _keys;
+    keyboard._curStateLen = SDL_SCANCODE_COUNT;
+    if (flags & FRAME_FLAG_KEYBOARD) {
+        uint8_t bitset[KEY_BITSET_BYTES];
+        if (!readBytes(bitset, KEY_BITSET_BYTES)) return false;
+        for (int i = 0; i < SDL_SCANCODE_COUNT; ++i) {
+            _keys[i] = (bitset[i / 8] >> (i % 8)) & 1;
+        }
+    }
+
+    MouseState &mouse = state.Mouse;
+    uint8_t relative = 0;
+    if (!read(mouse._curButtons) || !read(mouse._mousePos) || !read(mouse._mouseOffsetPos) ||
+        !read(mouse._scrollWheel) || !read(relative)) {
+        return false;
+    }
+    mouse._isRelative = relative != 0;
+
+    ControllerState &controller = state.Controller;
+    controller._isConnected = (flags & FRAME_FLAG_CONTROLLER) != 0;
+    if (controller._isConnected) {
+        uint8_t bitset[GAMEPAD_BITSET_BYTES];
+        if (!readBytes(bitset, GAMEPAD_BITSET_BYTES) || !read(controller._leftStick) ||
+            !read(controller._rightStick) || !read(controller._leftTrigger) ||
+            !read(controller._rightTrigger)) {
+            return false;
+        }
+        for (int i = 0; i < SDL_GAMEPAD_BUTTON_COUNT; ++i) {
+            controller._curButtons[i] = (bitset[i / 8] >> (i % 8)) & 1;
+        }
+    } else {
+        memset(controller._curButtons, 0, SDL_GAMEPAD_BUTTON_COUNT);
+        controller._leftStick = controller._rightStick = {0, 0};
+        controller._leftTrigger = controller._rightTrigger = 0;
+    }
+    return true;
+}
+
+template <class T>
+bool InputPlayer::read(T &out) {
+    return readBytes(&out, sizeof(T));
+}
+
+bool InputPlayer::readBytes(void *out, size_t size) {
+    if (_cursor + size > _data.size()) return false;
+    memcpy(out, _data.data() + _cursor, size);
+    _cursor += size;
+    return true;
+}
+
+}  // namespace luna
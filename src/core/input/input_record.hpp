@@ -0,0 +1,56 @@
+#pragma once
+
+#include <fstream>
+
+#include "input_system.hpp"
+
+// Record input state every frame with its delta time, and replay it later in place of SDL
+// so benchmark runs follow the exact same camera path and spawn timing
+//
+// file layout (native endian):
+//   header: magic "LINP", u32 version, u32 frame count
+//   frame : f32 delta time, u8 flags,
+//           [keyboard bitset, only when it changed since last frame],
+//           mouse (u32 buttons, vec2 pos, vec2 offset, vec2 scroll, u8 relative),
+//           [controller (button bitset, vec2 left, vec2 right, f32 triggers), when connected]
+
+namespace luna {
+
+constexpr uint32_t INPUT_RECORD_MAGIC = 0x504E494C;  // "LINP"
+constexpr uint32_t INPUT_RECORD_VERSION = 1;
+
+class InputRecorder {
+    public:
+        bool open(const std::string &path);
+        void close();
+        void capture(const InputState &state, float deltaTime);
+
+        [[nodiscard]] bool isOpen() const { return _file.is_open(); }
+
+    private:
+        std::ofstream _file;
+        uint32_t _frameCount = 0;
+        bool _lastKeys[SDL_SCANCODE_COUNT]{};
+        bool _hasLastKeys = false;
+};
+
+class InputPlayer {
+    public:
+        bool open(const std::string &path);
+        // write next recorded frame into state, false when the recording is exhausted
+        bool next(InputState &state, float &outDeltaTime);
+
+        [[nodiscard]] uint32_t getFrameCount() const { return _frameCount; }
+
+    private:
+        template <class T>
+        bool read(T &out);
+        bool readBytes(void *out, size_t size);
+
+        std::vector<uint8_t> _data;
+        size_t _cursor = 0;
+        uint32_t _frameCount = 0;
+        bool _keys[SDL_SCANCODE_COUNT]{};  // replayed keyboard state, keyboard points here
+};
+
+}  // namespace luna
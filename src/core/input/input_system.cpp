@@ -3,6 +3,7 @@
 #include <SDL3/SDL.h>
 
 #include "input_system.hpp"
+#include "input_record.hpp"
 
 namespace luna {
 
@@ -44,6 +45,9 @@ ButtonState ControllerState::getButtonState(SDL_GamepadButton button) const {
     }
 }
 
+InputSystem::InputSystem() = default;
+InputSystem::~InputSystem() = default;
+
 bool InputSystem::initialise() {
     // Keyboard
     // TODO: validate access to state with curlen
@@ -67,7 +71,29 @@ bool InputSystem::initialise() {
     return true;
 }
 
-void InputSystem::shutdown() { SDL_CloseGamepad(_controller); }
+void InputSystem::shutdown() {
+    if (_recorder) _recorder->close();
+    SDL_CloseGamepad(_controller);
+}
+
+bool InputSystem::startRecording(const std::string &path) {
+    _recorder = std::make_unique<InputRecorder>();
+    if (!_recorder->open(path)) {
+        _recorder = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool InputSystem::startReplay(const std::string &path) {
+    _player = std::make_unique<InputPlayer>();
+    if (!_player->open(path)) {
+        _player = nullptr;
+        return false;
+    }
+    _replayFinished = false;
+    return true;
+}
 
 void InputSystem::prepareForUpdate() {
     // Copy current state to previous (because SDL overwrite its original key buffer)
@@ -84,7 +110,21 @@ void InputSystem::prepareForUpdate() {
            SDL_GAMEPAD_BUTTON_COUNT);
 }
 
-void InputSystem::update() {
+void InputSystem::update(float deltaTime) {
+    _deltaTime = deltaTime;
+    if (_player) {
+        if (!_replayFinished && !_player->next(_inputState, _deltaTime)) {
+            SLog::get()->info("input replay finished");
+            _replayFinished = true;
+        }
+        return;
+    }
+
+    sampleDevices();
+    if (_recorder) _recorder->capture(_inputState, _deltaTime);
+}
+
+void InputSystem::sampleDevices() {
     // Do no update when window is not focused?
     if (!_mouseInWindow) return;
 
@@ -7,6 +7,8 @@
 #include "utils/common.hpp"
 
 namespace luna {
+class InputRecorder;
+class InputPlayer;
 
 enum ButtonState { ENone, EPressed, EReleased, EHeld };
 
@@ -14,6 +16,8 @@ class KeyboardState {
     public:
         // Friend so InputSystem can easily update it
         friend class InputSystem;
+        friend class InputRecorder;
+        friend class InputPlayer;
 
         // Get just the boolean true/false value of key
         [[nodiscard]] bool getKeyValue(SDL_Scancode keyCode) const;
@@ -30,6 +34,8 @@ class KeyboardState {
 class MouseState {
     public:
         friend class InputSystem;
+        friend class InputRecorder;
+        friend class InputPlayer;
 
         // For buttons
         [[nodiscard]] bool getButtonValue(int button) const;
@@ -56,6 +62,8 @@ class MouseState {
 class ControllerState {
     public:
         friend class InputSystem;
+        friend class InputRecorder;
+        friend class InputPlayer;
 
         // For buttons
         [[nodiscard]] bool getButtonValue(SDL_GamepadButton button) const;
@@ -91,27 +99,43 @@ struct InputState {
 
 class InputSystem {
     public:
+        InputSystem();
+        ~InputSystem();
+
         bool initialise();
         void shutdown();
 
         // Called right before SDL_PollEvents loop
         void prepareForUpdate();
-        // Called after SDL_PollEvents loop
-        void update();
+        // Called after SDL_PollEvents loop, delta time is what this frame will simulate with
+        void update(float deltaTime);
         // Called to process an SDL event in input system (like mouse wheel)
         void processEvent(union SDL_Event& event);
 
+        // Record / replay, replay replaces SDL sampling and frame delta time
+        bool startRecording(const std::string& path);
+        bool startReplay(const std::string& path);
+
         // GET SET
         [[nodiscard]] const InputState& getState() const { return _inputState; }
+        [[nodiscard]] float getDeltaTime() const { return _deltaTime; }
+        [[nodiscard]] bool isReplaying() const { return _player != nullptr; }
+        [[nodiscard]] bool isReplayFinished() const { return _replayFinished; }
         void setRelativeMouseMode(bool value);
 
     private:
+        void sampleDevices();
         static float filter1D(float input);
         static glm::vec2 filter2D(float inputX, float inputY);
 
         InputState _inputState{};
         SDL_Gamepad* _controller = nullptr;
         bool _mouseInWindow = true;
+
+        float _deltaTime = 0;
+        std::unique_ptr<InputRecorder> _recorder;
+        std::unique_ptr<InputPlayer> _player;
+        bool _replayFinished = false;
 };
 
 }  // namespace luna
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "job_system.hpp"
+#include "core/profile/profiler.hpp"
+#include "core/task/task_scheduler.hpp"
+
+namespace luna {
+
+JoltJobSystem::JoltJobSystem(TaskScheduler *scheduler, JPH::uint maxBarriers)
+    : JPH::JobSystemWithBarrier(maxBarriers), _scheduler(scheduler) {}
+
+int JoltJobSystem::GetMaxConcurrency() const {
+    // workers plus the thread calling PhysicsSystem::Update, which helps through the barrier
+    return _scheduler->getWorkerCount() + 1;
+}
+
+JPH::JobHandle JoltJobSystem::CreateJob(const char *inName, JPH::ColorArg inColor,
+                                        const JobFunction &inJobFunction,
+                                        JPH::uint32 inNumDependencies) {
+    // jobs are small and short-lived, the default allocator is good enough here
+    Job *job = new Job(inName, inColor, this, inJobFunction, inNumDependencies);
+    JobHandle handle(job);
+    if (inNumDependencies == 0) {
+        QueueJob(job);
+    }
+    return handle;
+}
+
+void JoltJobSystem::QueueJob(Job *inJob) {
+    // keep job alive until executed, the task releases this reference
+    inJob->AddRef();
+    _scheduler->submit([inJob]() {
+        ProfileScope scope(inJob->GetName());
+        inJob->Execute();
+        inJob->Release();
+    });
+}
+
+void JoltJobSystem::QueueJobs(Job **inJobs, JPH::uint inNumJobs) {
+    for (JPH::uint i = 0; i < inNumJobs; ++i) {
+        QueueJob(inJobs[i]);
+    }
+}
+
+void JoltJobSystem::FreeJob(Job *inJob) { delete inJob; }
+
+}  // namespace luna
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+#include "utils/common.hpp"
+
+// Jolt job system backed by the engine task scheduler so physic doesn't spin up its own pool
+
+namespace luna {
+class TaskScheduler;
+
+class JoltJobSystem final : public JPH::JobSystemWithBarrier {
+    public:
+        JoltJobSystem(TaskScheduler *scheduler, JPH::uint maxBarriers);
+        ~JoltJobSystem() override = default;
+
+        int GetMaxConcurrency() const override;
+        JobHandle CreateJob(const char *inName, JPH::ColorArg inColor,
+                            const JobFunction &inJobFunction,
+                            JPH::uint32 inNumDependencies = 0) override;
+
+    protected:
+        void QueueJob(Job *inJob) override;
+        void QueueJobs(Job **inJobs, JPH::uint inNumJobs) override;
+        void FreeJob(Job *inJob) override;
+
+    private:
+        TaskScheduler *_scheduler;
+};
+
+}  // namespace luna
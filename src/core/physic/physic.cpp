@@ -1,5 +1,3 @@
-#include <thread>
-
 #include "physic.hpp"
 
 namespace luna {
@@ -11,7 +9,7 @@ constexpr int MaxBodiesPairs = 65536;
 constexpr int MaxContactConstrain = 10240;
 constexpr int NumBodiesMutexes = 0;
 
-bool PhysicSystem::initialise() {
+bool PhysicSystem::initialise(TaskScheduler *scheduler) {
     // TODO: customisable physic configuration from initialisation arg
     // setup example:
     // https://github.com/jrouwe/JoltPhysicsHelloWorld/blob/main/Source/HelloWorld.cpp
@@ -19,9 +17,8 @@ bool PhysicSystem::initialise() {
     // JPH::Trace = TraceFunc // implement trace callback
     _joltAlloc =
         std::make_unique<JPH::TempAllocatorImpl>(PhyTempAllocSize);  // TODO: customise alloc impl
-    _jobSystem = std::make_unique<JPH::JobSystemThreadPool>(
-        JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
-        std::thread::hardware_concurrency() - 1);  // TODO: customise job impl
+    // jobs run on the engine task scheduler, sharing workers with other subsystems
+    _jobSystem = std::make_unique<JoltJobSystem>(scheduler, JPH::cMaxPhysicsBarriers);
 
     // factory and types
     JPH::Factory::sInstance = new JPH::Factory;
@@ -48,26 +45,8 @@ void PhysicSystem::shutdown() {
     JPH::Factory::sInstance = nullptr;
 }
 
-void PhysicSystem::update(float deltaTime) {
-    _accumUpdateS += deltaTime;
-
-    int totalCollisionSteps = 0;
-    while (_fixedUpdateStepS < _accumUpdateS) {
-        _accumUpdateS -= _fixedUpdateStepS;
-        totalCollisionSteps++;
-    }
-    if (totalCollisionSteps == 0) {
-        return;
-    }
-
-    if (totalCollisionSteps > 3) {
-        auto l = SLog::get();
-        l->warn(fmt::format("collision step drifting: {:d}", totalCollisionSteps));
-    }
-
-    // update
-    _joltPhysicSystem.Update(_fixedUpdateStepS, totalCollisionSteps, _joltAlloc.get(),
-                             _jobSystem.get());
+void PhysicSystem::step(float stepS) {
+    _joltPhysicSystem.Update(stepS, 1, _joltAlloc.get(), _jobSystem.get());
 }
 
 }  // namespace luna
\ No newline at end of file
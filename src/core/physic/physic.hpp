@@ -2,24 +2,26 @@
 
 #include <Jolt/Jolt.h>
 #include <Jolt/Core/Factory.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/ObjectLayer.h>
 
 #include "def.hpp"
+#include "job_system.hpp"
 #include "utils/common.hpp"
 
 // jolt physic has the same coordinate as our world space
 
 namespace luna {
+class TaskScheduler;
 
 class PhysicSystem {
     public:
-        bool initialise();
+        bool initialise(TaskScheduler *scheduler);
         void shutdown();
 
-        void update(float deltaTime);
+        // advance simulation by one fixed step, engine owns the accumulator
+        void step(float stepS);
 
         void static preInit() {
             JPH::RegisterDefaultAllocator();
@@ -31,13 +33,9 @@ class PhysicSystem {
         }  // locking, thread safe
 
     private:
-        // update related
-        const float _fixedUpdateStepS = 1.0f / 60.0f;
-        float _accumUpdateS = 0;
-
         // for temp alloc, rn fix it at 10MB
         std::unique_ptr<JPH::TempAllocatorImpl> _joltAlloc;
-        std::unique_ptr<JPH::JobSystemThreadPool> _jobSystem;
+        std::unique_ptr<JoltJobSystem> _jobSystem;
 
         // layers and broadcast implementation
         BPLayerInterfaceImpl _bpLayer{};
@@ -0,0 +1,143 @@
+#include <imgui.h>
+
+#include "hierarchy_panel.hpp"
+
+#include "actors/actor.hpp"
+
+namespace luna {
+
+void HierarchyPanel::actorAdded(ActorHandle handle) { addRoot(handle); }
+
+void HierarchyPanel::actorRemoved(Actor& actor, const ActorRegistry& registry) {
+    removeRoot(actor.getId());
+    for (ActorHandle child : actor.getChildrenIdList()) {
+        if (registry.isValid(child)) addRoot(child);
+    }
+    _structureDirty = true;
+}
+
+void HierarchyPanel::parentChanged(ActorHandle handle, bool isRoot) {
+    if (isRoot) {
+        addRoot(handle);
+    } else {
+        removeRoot(handle);
+    }
+    _structureDirty = true;
+}
+
+void HierarchyPanel::clear() {
+    _roots.clear();
+    _rootPos.clear();
+    _rows.clear();
+    _structureDirty = true;
+}
+
+void HierarchyPanel::addRoot(ActorHandle handle) {
+    uint32_t slot = actorHandleIndex(handle);
+    if (slot >= _rootPos.size()) _rootPos.resize(slot + 1, NO_ROOT);
+    if (_rootPos[slot] != NO_ROOT && _roots[_rootPos[slot]] == handle) return;
+    _rootPos[slot] = static_cast<uint32_t>(_roots.size());
+    _roots.push_back(handle);
+    _structureDirty = true;
+}
+
+void HierarchyPanel::removeRoot(ActorHandle handle) {
+    uint32_t slot = actorHandleIndex(handle);
+    if (slot >= _rootPos.size()) return;
+    uint32_t pos = _rootPos[slot];
+    if (pos == NO_ROOT || _roots[pos] != handle) return;
+    // swap remove, root order doesn't matter
+    ActorHandle last = _roots.back();
+    _roots[pos] = last;
+    _rootPos[actorHandleIndex(last)] = pos;
+    _roots.pop_back();
+    _rootPos[slot] = NO_ROOT;
+    _structureDirty = true;
+}
+
+void HierarchyPanel::appendSubtree(const ActorRegistry& registry, ActorHandle root) {
+    // depth first, only expanded actors push their children
+    _stackScratch.clear();
+    _stackScratch.push_back({root, 0});
+    while (!_stackScratch.empty()) {
+        Row row = _stackScratch.back();
+        _stackScratch.pop_back();
+        Actor* actor = registry.get(row.handle);
+        if (actor == nullptr) continue;
+        _rows.push_back(row);
+        if (!actor->getDebugUiExpand()) continue;
+        for (ActorHandle child : actor->getChildrenIdList()) {
+            _stackScratch.push_back({child, row.depth + 1});
+        }
+    }
+}
+
+void HierarchyPanel::rebuildRows(const ActorRegistry& registry) {
+    _rows.clear();
+    if (_filter[0] != '\0') {
+        // flat match list, names are cached by actor
+        const auto& actors = registry.getActors();
+        for (size_t i = 0; i < actors.size(); i++) {
+            if (actors[i]->debugDisplayName().find(_filter) != std::string::npos) {
+                _rows.push_back({registry.getHandleAt(i), 0});
+            }
+        }
+    } else {
+        for (ActorHandle root : _roots) {
+            appendSubtree(registry, root);
+        }
+    }
+    _structureDirty = false;
+    _rowsDirty = false;
+    _lastRebuildS = ImGui::GetTime();
+}
+
+void HierarchyPanel::draw(const ActorRegistry& registry) {
+    if (!_visible) return;
+    if (!ImGui::Begin("Engine##ActorHierarchy")) {
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::InputTextWithHint("##filter", "filter by name", _filter, sizeof(_filter))) {
+        _rowsDirty = true;
+    }
+    bool throttled = ImGui::GetTime() - _lastRebuildS < HIERARCHY_REBUILD_INTERVAL_S;
+    if (_rowsDirty || (_structureDirty && !throttled)) rebuildRows(registry);
+    ImGui::Text("actors: %zu  roots: %zu  rows: %zu", registry.size(), _roots.size(),
+                _rows.size());
+
+    ImGui::BeginChild("##rows");
+    float indent = ImGui::GetTreeNodeToLabelSpacing();
+    bool flat = _filter[0] != '\0';
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(_rows.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const Row& row = _rows[i];
+            Actor* actor = registry.get(row.handle);
+            if (actor == nullptr) {
+                // removed since the last rebuild, keep the row so clipper height stays valid
+                ImGui::TextDisabled("(removed)");
+                continue;
+            }
+            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + indent * static_cast<float>(row.depth));
+            ImGuiTreeNodeFlags flags =
+                ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanAvailWidth;
+            bool leaf = flat || actor->getChildrenIdList().empty();
+            if (leaf) flags |= ImGuiTreeNodeFlags_Leaf;
+            bool expanded = !leaf && actor->getDebugUiExpand();
+            ImGui::SetNextItemOpen(expanded);
+            bool open = ImGui::TreeNodeEx(reinterpret_cast<void*>(uintptr_t(row.handle)), flags,
+                                          "%s", actor->debugDisplayName().c_str());
+            if (!leaf && open != expanded) {
+                actor->setDebugUiExpand(open);
+                _rowsDirty = true;
+            }
+        }
+    }
+    ImGui::EndChild();
+    ImGui::End();
+}
+
+}  // namespace luna
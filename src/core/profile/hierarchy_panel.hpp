@@ -0,0 +1,54 @@
+#pragma once
+
+#include "utils/common.hpp"
+#include "core/scene/actor_registry.hpp"
+
+// ImGui actor hierarchy window
+// roots are tracked on add / remove / reparent instead of scanning every actor each frame,
+// the expanded tree is flattened into rows only when it changes and a list clipper submits just
+// the rows inside the scroll region, so per frame cost follows visible rows, not actor count
+// a non empty filter shows a flat list of every actor whose name contains it
+
+namespace luna {
+
+// spawn / despawn alone rebuilds rows at most this often, user interaction rebuilds at once
+constexpr double HIERARCHY_REBUILD_INTERVAL_S = 0.25;
+
+class HierarchyPanel {
+    public:
+        // new actor starts as root
+        void actorAdded(ActorHandle handle);
+        // call before the actor leaves the registry, its live children become roots
+        void actorRemoved(Actor& actor, const ActorRegistry& registry);
+        void parentChanged(ActorHandle handle, bool isRoot);
+        void clear();
+
+        void draw(const ActorRegistry& registry);
+        void toggleVisible() { _visible = !_visible; }
+
+    private:
+        static constexpr uint32_t NO_ROOT = UINT32_MAX;
+
+        struct Row {
+                ActorHandle handle;
+                int depth;
+        };
+
+        void addRoot(ActorHandle handle);
+        void removeRoot(ActorHandle handle);
+        void rebuildRows(const ActorRegistry& registry);
+        void appendSubtree(const ActorRegistry& registry, ActorHandle root);
+
+        bool _visible = true;
+        std::vector<ActorHandle> _roots;
+        std::vector<uint32_t> _rootPos;  // actor slot -> index in _roots
+
+        std::vector<Row> _rows;
+        std::vector<Row> _stackScratch;
+        bool _structureDirty = true;  // actors added / removed / reparented
+        bool _rowsDirty = true;       // expand state or filter changed
+        double _lastRebuildS = -1;
+        char _filter[64]{};
+};
+
+}  // namespace luna
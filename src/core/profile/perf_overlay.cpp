@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <imgui.h>
+
+#include "perf_overlay.hpp"
+
+namespace luna {
+
+// game thread phases, submit is ui build plus snapshot handoff, rendering runs on its own thread
+static const char *PHASE_NAMES[EPhaseCount] = {"wait", "input", "update", "submit"};
+
+void PerfOverlay::recordFrame(float frameMs, const std::array<float, EPhaseCount> &phaseMs) {
+    _frameMs[_historyPos] = frameMs;
+    for (int i = 0; i < EPhaseCount; ++i) {
+        _phaseMs[i][_historyPos] = phaseMs[i];
+    }
+    _historyPos = (_historyPos + 1) % PERF_HISTORY_SIZE;
+    _historySize = std::min(_historySize + 1, PERF_HISTORY_SIZE);
+}
+
+float PerfOverlay::percentile(float p) {
+    if (_historySize == 0) return 0;
+    std::copy_n(_frameMs.begin(), _historySize, _sortScratch.begin());
+    int nth = std::clamp(static_cast<int>(p * (_historySize - 1)), 0, _historySize - 1);
+    std::nth_element(_sortScratch.begin(), _sortScratch.begin() + nth,
+                     _sortScratch.begin() + _historySize);
+    return _sortScratch[nth];
+}
+
+void PerfOverlay::draw(const RenderStats &stats) {
+    if (!_visible) return;
+    if (!ImGui::Begin("Performance##PerfOverlay")) {
+        ImGui::End();
+        return;
+    }
+
+    // frame time
+    float p50 = percentile(0.5f);
+    float p99 = percentile(0.99f);
+    float maxMs = _historySize > 0
+                      ? *std::max_element(_frameMs.begin(), _frameMs.begin() + _historySize)
+                      : 0.0f;
+    ImGui::Text("FPS: %.1f  p50: %.2fms  p99: %.2fms  max: %.2fms",
+                p50 > 0 ? 1000.0f / p50 : 0.0f, p50, p99, maxMs);
+    // oldest entry is at _historyPos once the ring is full
+    int offset = _historySize == PERF_HISTORY_SIZE ? _historyPos : 0;
+    ImGui::PlotHistogram("##frameTime", _frameMs.data(), _historySize, offset, "frame ms", 0,
+                         std::max(maxMs, 1000.0f / 30.0f), ImVec2(0, 60));
+
+    // per phase average over the window
+    if (ImGui::BeginTable("##phases", 3, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("phase");
+        ImGui::TableSetupColumn("avg ms");
+        ImGui::TableSetupColumn("last ms");
+        ImGui::TableHeadersRow();
+        int lastPos = (_historyPos + PERF_HISTORY_SIZE - 1) % PERF_HISTORY_SIZE;
+        for (int phase = 0; phase < EPhaseCount; ++phase) {
+            float sum = 0;
+            for (int i = 0; i < _historySize; ++i) {
+                sum += _phaseMs[phase][i];
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(PHASE_NAMES[phase]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", _historySize > 0 ? sum / _historySize : 0.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", _historySize > 0 ? _phaseMs[phase][lastPos] : 0.0f);
+        }
+        ImGui::EndTable();
+    }
+
+    // gpu
+    ImGui::Separator();
+    ImGui::Text("GPU mrt: %.3fms  comp: %.3fms", stats.gpuMrtMs, stats.gpuCompMs);
+    if (stats.gpuDriven) {
+        ImGui::Text("Draw calls: %u  Triangles: %llu before gpu culling", stats.drawCalls,
+                    static_cast<unsigned long long>(stats.candidateTriangles));
+    } else {
+        ImGui::Text("Draw calls: %u  Triangles: %llu", stats.drawCalls,
+                    static_cast<unsigned long long>(stats.triangles));
+    }
+    ImGui::Text("Instances: %u in %u batches", stats.instances, stats.batches);
+    if (stats.gpuDriven) ImGui::Text("GPU driven, %u candidate draws", stats.drawCandidates);
+
+    // memory, per vma heap
+    ImGui::Separator();
+    for (uint32_t i = 0; i < stats.heapCount; ++i) {
+        float usageMb = static_cast<float>(stats.heapUsage[i]) / (1024.0f * 1024.0f);
+        float budgetMb = static_cast<float>(stats.heapBudget[i]) / (1024.0f * 1024.0f);
+        ImGui::Text("Heap %u: %.1f / %.1f MB", i, usageMb, budgetMb);
+        ImGui::SameLine();
+        ImGui::ProgressBar(budgetMb > 0 ? usageMb / budgetMb : 0.0f, ImVec2(-1, 0), "");
+    }
+    float stagingMb = static_cast<float>(stats.stagingUsed) / (1024.0f * 1024.0f);
+    float stagingSizeMb = static_cast<float>(stats.stagingSize) / (1024.0f * 1024.0f);
+    ImGui::Text("Staging: %.1f / %.1f MB  stalls: %u", stagingMb, stagingSizeMb,
+                stats.stagingStalls);
+    ImGui::Text("Geometry: %.1f / %.1f MB",
+                static_cast<float>(stats.geometryUsed) / (1024.0f * 1024.0f),
+                static_cast<float>(stats.geometrySize) / (1024.0f * 1024.0f));
+
+    ImGui::End();
+}
+
+}  // namespace luna
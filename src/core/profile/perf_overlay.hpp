@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/renderer/def.hpp"
+#include "utils/common.hpp"
+
+// ImGui performance panel, all history lives in preallocated ring buffers so drawing the panel
+// doesn't allocate and skew the numbers it shows
+
+namespace luna {
+
+constexpr int PERF_HISTORY_SIZE = 240;
+
+enum PerfPhase { EPhaseWait, EPhaseInput, EPhaseUpdate, EPhaseSubmit, EPhaseCount };
+
+class PerfOverlay {
+    public:
+        // frameMs is frame to frame time, phaseMs is the time spent in each engine phase
+        void recordFrame(float frameMs, const std::array<float, EPhaseCount> &phaseMs);
+        void draw(const RenderStats &stats);
+
+        void toggleVisible() { _visible = !_visible; }
+
+    private:
+        // return value at percentile [0, 1] of the frame time history
+        float percentile(float p);
+
+        bool _visible = true;
+        std::array<float, PERF_HISTORY_SIZE> _frameMs{};
+        std::array<std::array<float, PERF_HISTORY_SIZE>, EPhaseCount> _phaseMs{};
+        std::array<float, PERF_HISTORY_SIZE> _sortScratch{};
+        int _historyPos = 0;
+        int _historySize = 0;
+};
+
+}  // namespace luna
@@ -0,0 +1,115 @@
+#include <fstream>
+
+#include "profiler.hpp"
+
+namespace luna {
+
+static thread_local ProfileThreadBuffer *tBuffer = nullptr;
+
+Profiler::Profiler() : _epoch(Clock::now()) {
+    auto gpuBuffer = std::make_unique<ProfileThreadBuffer>();
+    gpuBuffer->threadName = "GPU";
+    gpuBuffer->threadId = 0;
+    _gpuBuffer = gpuBuffer.get();
+    _buffers.push_back(std::move(gpuBuffer));
+}
+
+ProfileThreadBuffer *Profiler::threadBuffer() {
+    if (tBuffer == nullptr) {
+        std::lock_guard lock(_registerMutex);
+        auto buffer = std::make_unique<ProfileThreadBuffer>();
+        buffer->threadId = static_cast<int>(_buffers.size());
+        buffer->threadName = fmt::format("Thread {:d}", buffer->threadId);
+        tBuffer = buffer.get();
+        _buffers.push_back(std::move(buffer));
+    }
+    return tBuffer;
+}
+
+void Profiler::setThreadName(const std::string &name) {
+    ProfileThreadBuffer *buffer = threadBuffer();
+    std::lock_guard lock(_registerMutex);
+    buffer->threadName = name;
+}
+
+void Profiler::beginCapture(int frameCount, const std::string &outputPath) {
+    if (isCapturing() || frameCount <= 0) return;
+    auto l = SLog::get();
+    l->info(fmt::format("profiler capturing {:d} frames", frameCount));
+    _framesLeft = frameCount;
+    _outputPath = outputPath;
+    // buffers notice the new id on their next event and restart from zero
+    _captureId.fetch_add(1, std::memory_order_relaxed);
+    _capturing.store(true, std::memory_order_release);
+}
+
+void Profiler::endFrame() {
+    if (!isCapturing()) return;
+    if (--_framesLeft > 0) return;
+    _capturing.store(false, std::memory_order_release);
+    writeTrace(_outputPath);
+}
+
+void Profiler::record(const char *name, int64_t startNs, int64_t endNs) {
+    if (!isCapturing()) return;
+    push(*threadBuffer(), name, startNs, endNs);
+}
+
+void Profiler::recordGpu(const char *name, int64_t startNs, int64_t endNs) {
+    if (!isCapturing()) return;
+    push(*_gpuBuffer, name, startNs, endNs);
+}
+
+void Profiler::push(ProfileThreadBuffer &buffer, const char *name, int64_t startNs,
+                    int64_t endNs) {
+    uint32_t captureId = _captureId.load(std::memory_order_relaxed);
+    if (buffer.captureId.load(std::memory_order_relaxed) != captureId) {
+        // reset count before publishing the id, trace writer reads them in the opposite order
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.captureId.store(captureId, std::memory_order_release);
+    }
+    uint32_t idx = buffer.count.load(std::memory_order_relaxed);
+    if (idx >= PROFILE_EVENTS_PER_THREAD) return;  // full, drop
+    buffer.events[idx] = {name, startNs, endNs - startNs};
+    buffer.count.store(idx + 1, std::memory_order_release);
+}
+
+bool Profiler::writeTrace(const std::string &path) {
+    auto l = SLog::get();
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        l->error(fmt::format("failed to open profile output {:s}", path));
+        return false;
+    }
+
+    std::lock_guard lock(_registerMutex);
+    uint32_t captureId = _captureId.load(std::memory_order_relaxed);
+    size_t totalEvents = 0;
+    bool first = true;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const auto &buffer : _buffers) {
+        if (buffer->captureId.load(std::memory_order_acquire) != captureId) continue;
+        file << (first ? "" : ",\n")
+             << fmt::format(R"({{"name":"thread_name","ph":"M","pid":0,"tid":{:d},)"
+                            R"("args":{{"name":"{:s}"}}}})",
+                            buffer->threadId, buffer->threadName);
+        first = false;
+
+        uint32_t count = buffer->count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            const ProfileEvent &e = buffer->events[i];
+            // chrome trace time unit is microsecond
+            file << fmt::format(
+                ",\n{{\"name\":\"{:s}\",\"ph\":\"X\",\"pid\":0,\"tid\":{:d},\"ts\":{:.3f},"
+                "\"dur\":{:.3f}}}",
+                e.name, buffer->threadId, e.startNs / 1000.0, e.durationNs / 1000.0);
+        }
+        totalEvents += count;
+    }
+    file << "\n]}\n";
+
+    l->info(fmt::format("wrote {:d} profile events to {:s}", totalEvents, path));
+    return true;
+}
+
+}  // namespace luna
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "utils/common.hpp"
+
+// Scoped cpu timers and gpu pass timings, exported as chrome trace json
+// (load in chrome://tracing, perfetto or https://www.speedscope.app/)
+//
+// every thread records into its own fixed size buffer, only the owner thread writes to it so the
+// hot path is lock free. buffers are registered once per thread and stay alive until exit.
+
+#define LUNA_PROFILE_CONCAT_INNER(a, b) a##b
+#define LUNA_PROFILE_CONCAT(a, b) LUNA_PROFILE_CONCAT_INNER(a, b)
+// name must be a string literal (or outlive the capture)
+#define PROFILE_SCOPE(name) \
+    ::luna::ProfileScope LUNA_PROFILE_CONCAT(_profileScope, __LINE__) { name }
+
+namespace luna {
+
+constexpr int PROFILE_EVENTS_PER_THREAD = 1 << 16;
+
+struct ProfileEvent {
+        const char *name;
+        int64_t startNs;
+        int64_t durationNs;
+};
+
+// events recorded by a single thread (or the gpu timeline)
+struct ProfileThreadBuffer {
+        std::string threadName;
+        int threadId = 0;
+        std::atomic<uint32_t> captureId{0};  // capture this buffer content belongs to
+        std::atomic<uint32_t> count{0};      // published events, both written by owner only
+        std::array<ProfileEvent, PROFILE_EVENTS_PER_THREAD> events{};
+};
+
+class Profiler {
+    public:
+        Profiler(const Profiler &) = delete;
+        Profiler &operator=(const Profiler &) = delete;
+
+        static Profiler *get() {
+            static Profiler instance{};
+            return &instance;
+        }
+
+        // capture the next n frames, then write trace to path
+        void beginCapture(int frameCount, const std::string &outputPath);
+        // call once per frame from game thread, finishes capture when countdown hits zero
+        void endFrame();
+        [[nodiscard]] bool isCapturing() const {
+            return _capturing.load(std::memory_order_relaxed);
+        }
+
+        // name shown in trace for the calling thread
+        void setThreadName(const std::string &name);
+        void record(const char *name, int64_t startNs, int64_t endNs);
+        // gpu timeline, only called from render thread
+        void recordGpu(const char *name, int64_t startNs, int64_t endNs);
+
+        [[nodiscard]] int64_t nowNs() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _epoch)
+                .count();
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Profiler();
+        ProfileThreadBuffer *threadBuffer();
+        void push(ProfileThreadBuffer &buffer, const char *name, int64_t startNs, int64_t endNs);
+        bool writeTrace(const std::string &path);
+
+        Clock::time_point _epoch;
+        std::atomic<bool> _capturing{false};
+        std::atomic<uint32_t> _captureId{0};
+        int _framesLeft = 0;
+        std::string _outputPath;
+
+        // registration only, never touched while recording
+        std::mutex _registerMutex;
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> _buffers;
+        ProfileThreadBuffer *_gpuBuffer = nullptr;
+};
+
+class ProfileScope {
+    public:
+        explicit ProfileScope(const char *name) : _name(name) {
+            if (Profiler::get()->isCapturing()) _startNs = Profiler::get()->nowNs();
+        }
+        ~ProfileScope() {
+            if (_startNs >= 0) Profiler::get()->record(_name, _startNs, Profiler::get()->nowNs());
+        }
+
+    private:
+        const char *_name;
+        int64_t _startNs = -1;
+};
+
+}  // namespace luna
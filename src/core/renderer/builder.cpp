@@ -115,6 +115,25 @@ DescriptorBuilder& DescriptorBuilder::pushDefaultFragmentSamplerBinding(int targ
     return *this;
 }
 
+DescriptorBuilder& DescriptorBuilder::pushDefaultStorageBuffer(int targetSet,
+                                                               VkShaderStageFlags stageFlag) {
+    if (!inConstrain(targetSet)) {
+        return *this;
+    }
+
+    // binding desc
+    VkDescriptorSetLayoutBinding newBinding{};
+    newBinding.binding = _setInfoList[targetSet].setBinding.size();
+    newBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    newBinding.descriptorCount = 1;
+    newBinding.pImmutableSamplers = nullptr;
+    newBinding.stageFlags = stageFlag;
+
+    _setInfoList[targetSet].setBinding.push_back(newBinding);
+
+    return *this;
+}
+
 DescriptorBuilder& DescriptorBuilder::clearSetWrite(int targetSet) {
     auto l = SLog::get();
     if (targetSet < -1) {
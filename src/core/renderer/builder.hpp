@@ -32,6 +32,7 @@ class DescriptorBuilder {
         DescriptorBuilder& pushDefaultUniform(
             int targetSet, VkShaderStageFlags stageFlag = VK_SHADER_STAGE_VERTEX_BIT);
         DescriptorBuilder& pushDefaultFragmentSamplerBinding(int targetSet);
+        DescriptorBuilder& pushDefaultStorageBuffer(int targetSet, VkShaderStageFlags stageFlag);
         DescriptorBuilder& clearSetWrite(int targetSet = -1);
         DescriptorBuilder& pushSetWriteImgSampler(int targetSet, VkImageView imgView,
                                                   VkSampler sampler, int targetBinding = -1);
@@ -170,6 +170,31 @@ class CreationHelper {
                                    &outAllocInfo);
         }
 
+        // host written buffers are persistently mapped, the rest are device local
+        static VkResult createStorageBuffer(VmaAllocator allocator, VkDeviceSize bufSize,
+                                            VkBufferUsageFlags usage, bool hostWrite,
+                                            BufferResource &outBuf) {
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = bufSize;
+            bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VmaAllocationCreateInfo createAllocInfo{};
+            createAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+            if (hostWrite) {
+                createAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                                        VMA_ALLOCATION_CREATE_MAPPED_BIT;
+                createAllocInfo.requiredFlags =
+                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;  // to avoid flushing
+            } else {
+                createAllocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            }
+
+            return vmaCreateBuffer(allocator, &bufferInfo, &createAllocInfo, &outBuf.buffer,
+                                   &outBuf.allocation, &outBuf.allocInfo);
+        }
+
         static std::vector<char> readFile(const std::string &filename) {
             std::ifstream f(filename, std::ios::ate | std::ios::binary);
 
@@ -3,6 +3,8 @@
 #include "stb_image.h"
 #include "vk_mem_alloc.h"
 
+struct ImDrawList;
+
 #define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
 #include "utils/common.hpp"
 
@@ -12,6 +14,9 @@ struct RenderConfig {
         int maxFrameInFlight = 2;
         int windowWidth = 1700;
         int windowHeight = 900;
+        bool headless = false;  // no window/swapchain, composition renders into offscreen images
+        uint32_t stagingRingMb = 64;  // persistent upload staging, larger assets are chunked
+        bool gpuDriven = true;  // cull and draw from compute written commands when supported
         VkDebugUtilsMessageSeverityFlagBitsEXT callbackSeverity =
             VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
 };
@@ -34,11 +39,72 @@ struct MrtUboData {
         void setHeight() { textureToggle |= 0b10000; }
 };
 
+// model transform is per instance, read from the instance buffer
 struct MrtPushConstantData {
-        glm::mat4 viewModalTransform;
+        glm::mat4 viewTransform;
         glm::mat4 perspectiveTransform;
 };
 
+struct CullPushConstantData {
+        glm::vec4 frustumPlanes[6];  // world space, pointing inward
+        uint32_t itemCount;  // instances in the cull pass, draws in the emit pass
+        uint32_t pass;
+};
+
+// one per drawn instance, grouped by batch, the cpu path binds it as instance rate vertex input
+// storage buffer layouts below are mirrored in cull.comp and mrt_indirect.*
+struct GpuInstanceData {
+        glm::mat4 worldTransform;
+        uint32_t batchIdx;
+        uint32_t pad[3];
+
+        static VkVertexInputBindingDescription getBindingDescription() {
+            VkVertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 1;
+            bindingDescription.stride = sizeof(GpuInstanceData);
+            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+            return bindingDescription;
+        }
+
+        // mat4 takes one location per column, after the Vertex attributes
+        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() {
+            std::vector<VkVertexInputAttributeDescription> attributeDescriptions(4);
+            for (uint32_t i = 0; i < 4; ++i) {
+                attributeDescriptions[i].binding = 1;
+                attributeDescriptions[i].location = 5 + i;
+                attributeDescriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+                attributeDescriptions[i].offset = sizeof(glm::vec4) * i;
+            }
+            return attributeDescriptions;
+        }
+};
+
+// instances sharing a mesh, culled together into one instanced draw per partition
+struct GpuBatchData {
+        glm::vec4 boundsMin;  // model space
+        glm::vec4 boundsMax;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+        uint32_t pad[2];
+};
+
+struct GpuDrawData {
+        uint32_t batchIdx;
+        uint32_t materialSlot;
+        uint32_t firstIndex;  // absolute in the index arena
+        uint32_t indexCount;
+        int32_t vertexOffset;
+};
+
+struct GpuMaterialData {
+        glm::vec4 diffuse;
+        glm::vec4 emissive;
+        int textureToggle;
+        uint32_t albedoSlot;  // into the bindless texture array
+        uint32_t normalSlot;
+        uint32_t aoRoughnessHeightSlot;
+};
+
 struct DirectionalLight {
         glm::vec4 position;
         glm::vec4 color;
@@ -49,9 +115,11 @@ struct PointLight {
         glm::vec4 colorAndRadius;
 };
 
+constexpr int MAX_POINT_LIGHTS = 6;
+
 struct CompUboData {
         DirectionalLight dirLight;
-        PointLight lights[6];
+        PointLight lights[MAX_POINT_LIGHTS];
         glm::vec4 camPos;
 };
 
@@ -130,6 +198,12 @@ struct ImgResource {
         VmaAllocation allocation;
 };
 
+struct BufferResource {
+        VkBuffer buffer{};
+        VmaAllocation allocation{};
+        VmaAllocationInfo allocInfo{};
+};
+
 // partition single model into group of indices and materials
 struct ModelDataPartition {
         int firstIndex{};
@@ -166,20 +240,80 @@ struct MaterialGpu {
         ImgResource albedoTex{};             // rgb - albedo, a is unused because this is SNORM
         ImgResource normalTex{};             // rgb - normal, a -
         ImgResource aoRoughnessHeight = {};  // r - ao, g - roughness, b - height, a -
+
+        // gpu driven path, slots in the bindless material buffer and texture array
+        uint32_t materialSlot = UINT32_MAX;
+        std::array<uint32_t, 3> textureSlots = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
 };
 
-// shared state between model handler and renderer
-struct ModalState {
-        // update by application
-        glm::mat4 worldTransform{};
+// gpu buffers and materials of one model, shared by every instance drawing it
+// released by renderer once only its mesh list still references it
+struct MeshGpu {
         // populated by renderer
-        VmaAllocation vAllocation{};
-        VmaAllocation iAllocation{};
-        VkBuffer vBuffer{};
-        VkBuffer iBuffer{};
+        uint32_t vertexRange = UINT32_MAX;  // handles into the renderer geometry arenas
+        uint32_t indexRange = UINT32_MAX;
         uint32_t indicesSize{};
+        glm::vec3 boundsMin{};  // model space, for culling and spatial queries
+        glm::vec3 boundsMax{};
 
         std::vector<ModelDataPartition> modelDataPartition{};
 };
 
+// per instance state shared between model handler and renderer
+struct ModalState {
+        // update by application
+        glm::mat4 worldTransform{};
+        std::shared_ptr<MeshGpu> mesh;
+        // populated by renderer, position in its instance list
+        uint32_t listIdx{};
+        // drawn when equal to the renderer cull stamp, ignored while culling is off
+        uint64_t visibleStamp{};
+};
+
+// collected by render thread once per frame, read by the performance overlay
+struct RenderStats {
+        uint32_t drawCalls = 0;
+        uint64_t triangles = 0;  // cpu path, drawn
+        uint64_t candidateTriangles = 0;  // gpu driven path, before gpu culling
+        float gpuMrtMs = 0;  // last completed frame
+        float gpuCompMs = 0;
+        uint32_t heapCount = 0;
+        std::array<uint64_t, VK_MAX_MEMORY_HEAPS> heapUsage{};
+        std::array<uint64_t, VK_MAX_MEMORY_HEAPS> heapBudget{};
+        uint64_t stagingUsed = 0;  // bytes not yet released by the gpu
+        uint64_t stagingSize = 0;
+        uint32_t stagingStalls = 0;  // total waits for ring space
+        uint64_t geometryUsed = 0;  // vertex + index arena bytes
+        uint64_t geometrySize = 0;
+        uint32_t instances = 0;
+        uint32_t batches = 0;  // distinct meshes, one instanced draw per partition
+        bool gpuDriven = false;
+        uint32_t drawCandidates = 0;  // batch partitions handed to gpu culling
+};
+
+// instances drawing the same mesh, transforms are copied so game can keep updating the modal
+// states, mesh is kept alive by deferred delete until no snapshot in flight can reference it
+struct RenderBatch {
+        const MeshGpu *mesh;
+        uint32_t firstInstance;  // into RenderSnapshot::instanceTransforms
+        uint32_t instanceCount;
+};
+
+// everything render thread needs to draw a frame, written by game thread and published as a
+// whole so the render thread never reads game state directly
+struct RenderSnapshot {
+        glm::mat4 camViewTransform{};
+        glm::mat4 camProjectionTransform{};
+        CompUboData compUboData{};
+        int lightCount = 0;
+        std::vector<RenderBatch> batches;
+        std::vector<glm::mat4> instanceTransforms;  // grouped by batch
+
+        // cloned imgui output, owned by the snapshot until rendered
+        std::vector<ImDrawList *> uiDrawLists;
+        glm::vec2 uiDisplayPos{};
+        glm::vec2 uiDisplaySize{};
+        glm::vec2 uiFramebufferScale{1, 1};
+};
+
 }  // namespace luna
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <algorithm>
+
+#include "geometry_arena.hpp"
+
+namespace luna {
+
+bool GeometryArena::initialise(VmaAllocator allocator, UploadManager &uploads,
+                               VkBufferUsageFlags usage, uint32_t stride, uint32_t capacity) {
+    _allocator = allocator;
+    _uploads = &uploads;
+    _usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    _stride = stride;
+    _capacity = std::max(capacity, 1u);
+    _freeBlocks[0] = _capacity;
+    return createBuffer(_capacity, _buffer, _allocation);
+}
+
+void GeometryArena::shutdown() {
+    for (auto &[buffer, allocation] : _retired) {
+        vmaDestroyBuffer(_allocator, buffer, allocation);
+    }
+    _retired.clear();
+    if (_buffer != VK_NULL_HANDLE) vmaDestroyBuffer(_allocator, _buffer, _allocation);
+    _buffer = VK_NULL_HANDLE;
+    _freeBlocks.clear();
+    _ranges.clear();
+    _freeRangeIds.clear();
+}
+
+bool GeometryArena::createBuffer(uint32_t capacity, VkBuffer &buffer, VmaAllocation &allocation) {
+    auto l = SLog::get();
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = static_cast<VkDeviceSize>(capacity) * _stride;
+    bufferInfo.usage = _usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    _uploads->applySharing(bufferInfo);
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    allocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    if (vmaCreateBuffer(_allocator, &bufferInfo, &allocInfo, &buffer, &allocation, nullptr) !=
+        VK_SUCCESS) {
+        l->error(fmt::format("failed to create geometry arena of {:d} bytes", bufferInfo.size));
+        return false;
+    }
+    return true;
+}
+
+bool GeometryArena::takeBlock(uint32_t count, uint32_t &offset) {
+    auto best = _freeBlocks.end();
+    for (auto iter = _freeBlocks.begin(); iter != _freeBlocks.end(); ++iter) {
+        if (iter->second < count) continue;
+        if (best == _freeBlocks.end() || iter->second < best->second) best = iter;
+        if (best->second == count) break;
+    }
+    if (best == _freeBlocks.end()) return false;
+    offset = best->first;
+    uint32_t remain = best->second - count;
+    _freeBlocks.erase(best);
+    if (remain > 0) _freeBlocks[offset + count] = remain;
+    return true;
+}
+
+uint32_t GeometryArena::allocate(uint32_t count) {
+    uint32_t offset = 0;
+    if (count > 0 && !takeBlock(count, offset)) {
+        // enough space in total means it's only fragmented, pack it, grow otherwise
+        uint32_t needed = _used + count;
+        uint32_t capacity = needed <= _capacity ? _capacity : std::max(_capacity * 2, needed);
+        if (!relocate(capacity) || !takeBlock(count, offset)) return GEOMETRY_NULL_RANGE;
+    }
+    _used += count;
+
+    uint32_t range;
+    if (_freeRangeIds.empty()) {
+        range = static_cast<uint32_t>(_ranges.size());
+        _ranges.emplace_back();
+    } else {
+        range = _freeRangeIds.back();
+        _freeRangeIds.pop_back();
+    }
+    _ranges[range] = {offset, count, true};
+    return range;
+}
+
+void GeometryArena::free(uint32_t range) {
+    Range &r = _ranges[range];
+    if (r.count > 0) {
+        uint32_t offset = r.offset;
+        uint32_t count = r.count;
+        // merge with the free neighbours
+        auto next = _freeBlocks.lower_bound(offset);
+        if (next != _freeBlocks.end() && next->first == offset + count) {
+            count += next->second;
+            next = _freeBlocks.erase(next);
+        }
+        if (next != _freeBlocks.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                offset = prev->first;
+                count += prev->second;
+                _freeBlocks.erase(prev);
+            }
+        }
+        _freeBlocks[offset] = count;
+        _used -= r.count;
+    }
+    r = {};
+    _freeRangeIds.push_back(range);
+}
+
+bool GeometryArena::compactIfFragmented() {
+    uint32_t tailFree = 0;
+    if (!_freeBlocks.empty()) {
+        auto last = std::prev(_freeBlocks.end());
+        if (last->first + last->second == _capacity) tailFree = last->second;
+    }
+    uint32_t holes = _capacity - _used - tailFree;
+    if (holes <= _capacity / 4) return false;
+    return relocate(_capacity);
+}
+
+bool GeometryArena::relocate(uint32_t newCapacity) {
+    auto l = SLog::get();
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    if (!createBuffer(newCapacity, buffer, allocation)) return false;
+
+    std::vector<uint32_t> order;
+    order.reserve(_ranges.size());
+    for (uint32_t i = 0; i < _ranges.size(); i++) {
+        if (_ranges[i].live && _ranges[i].count > 0) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(),
+              [this](uint32_t a, uint32_t b) { return _ranges[a].offset < _ranges[b].offset; });
+
+    // ranges adjacent in both buffers become one copy region
+    std::vector<VkBufferCopy> regions;
+    uint32_t cursor = 0;
+    for (uint32_t i : order) {
+        Range &r = _ranges[i];
+        VkDeviceSize src = static_cast<VkDeviceSize>(r.offset) * _stride;
+        VkDeviceSize dst = static_cast<VkDeviceSize>(cursor) * _stride;
+        VkDeviceSize size = static_cast<VkDeviceSize>(r.count) * _stride;
+        if (!regions.empty() && regions.back().srcOffset + regions.back().size == src &&
+            regions.back().dstOffset + regions.back().size == dst) {
+            regions.back().size += size;
+        } else {
+            regions.push_back({src, dst, size});
+        }
+        r.offset = cursor;
+        cursor += r.count;
+    }
+    _uploads->copyBuffer(_buffer, buffer, regions);
+    l->debug(fmt::format("geometry arena relocated, {:d} -> {:d} elements, {:d} copy regions",
+                         _capacity, newCapacity, regions.size()));
+
+    _retired.emplace_back(_buffer, _allocation);
+    _buffer = buffer;
+    _allocation = allocation;
+    _capacity = newCapacity;
+    _freeBlocks.clear();
+    if (cursor < _capacity) _freeBlocks[cursor] = _capacity - cursor;
+    return true;
+}
+
+}  // namespace luna
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <map>
+
+#include "vk_mem_alloc.h"
+
+#include "utils/common.hpp"
+#include "upload_manager.hpp"
+
+// Suballocated device local buffer shared by every mesh
+// a mesh owns a range handle instead of its own buffer, so a pass binds the arena once and draws
+// with vertex / index offsets, free blocks are kept by offset and merged with their neighbours
+// when no block fits the arena is packed (enough space, only fragmented) or grown into a fresh
+// buffer with a gpu copy, offsets behind a handle change then, the replaced buffer is handed back
+// for deferred destruction since frames in flight may still read it
+// render thread only
+
+namespace luna {
+
+constexpr uint32_t GEOMETRY_NULL_RANGE = UINT32_MAX;
+
+class GeometryArena {
+    public:
+        // sizes are in elements of stride bytes, usage gets transfer src / dst added
+        bool initialise(VmaAllocator allocator, UploadManager &uploads, VkBufferUsageFlags usage,
+                        uint32_t stride, uint32_t capacity);
+        void shutdown();
+
+        // return range handle, may grow or pack the arena, GEOMETRY_NULL_RANGE when out of memory
+        uint32_t allocate(uint32_t count);
+        void free(uint32_t range);
+        // pack live ranges to the front when holes waste a quarter of the arena
+        bool compactIfFragmented();
+
+        [[nodiscard]] VkBuffer getBuffer() const { return _buffer; }
+        [[nodiscard]] uint32_t getOffset(uint32_t range) const { return _ranges[range].offset; }
+        [[nodiscard]] VkDeviceSize getByteOffset(uint32_t range) const {
+            return static_cast<VkDeviceSize>(_ranges[range].offset) * _stride;
+        }
+        [[nodiscard]] uint32_t getCapacity() const { return _capacity; }
+        [[nodiscard]] uint32_t getUsed() const { return _used; }
+        [[nodiscard]] uint32_t getStride() const { return _stride; }
+        // buffers replaced since the last call, caller destroys them once no frame reads them
+        std::vector<std::pair<VkBuffer, VmaAllocation>> takeRetired() {
+            return std::exchange(_retired, {});
+        }
+
+    private:
+        struct Range {
+                uint32_t offset = 0;
+                uint32_t count = 0;
+                bool live = false;
+        };
+
+        bool createBuffer(uint32_t capacity, VkBuffer &buffer, VmaAllocation &allocation);
+        // best fit, false when no free block is large enough
+        bool takeBlock(uint32_t count, uint32_t &offset);
+        // move live ranges, packed in offset order, into a new buffer of newCapacity elements
+        bool relocate(uint32_t newCapacity);
+
+        VmaAllocator _allocator{};
+        UploadManager *_uploads{};
+        VkBufferUsageFlags _usage{};
+        uint32_t _stride = 0;
+
+        VkBuffer _buffer{};
+        VmaAllocation _allocation{};
+        uint32_t _capacity = 0;
+        uint32_t _used = 0;
+        std::map<uint32_t, uint32_t> _freeBlocks;  // offset -> count
+
+        std::vector<Range> _ranges;
+        std::vector<uint32_t> _freeRangeIds;
+        std::vector<std::pair<VkBuffer, VmaAllocation>> _retired;
+};
+
+}  // namespace luna
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "utils/common.hpp"
+#include "def.hpp"
+
+// Uploaded meshes by source key (model path or generator parameters), spawning the same model
+// again skips parsing and upload and shares gpu buffers and materials
+// game thread only, cleared with the scene so renderer can release meshes nobody draws
+
+namespace luna {
+
+class MeshCache {
+    public:
+        [[nodiscard]] std::shared_ptr<MeshGpu> find(const std::string &key) const {
+            auto iter = _meshes.find(key);
+            return iter == _meshes.end() ? nullptr : iter->second;
+        }
+        void insert(const std::string &key, const std::shared_ptr<MeshGpu> &mesh) {
+            _meshes[key] = mesh;
+        }
+        void clear() { _meshes.clear(); }
+        [[nodiscard]] size_t size() const { return _meshes.size(); }
+
+    private:
+        std::unordered_map<std::string, std::shared_ptr<MeshGpu>> _meshes;
+};
+
+}  // namespace luna
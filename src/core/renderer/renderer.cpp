@@ -1,6 +1,8 @@
 #include "SDL3/SDL.h"
 #include "SDL3/SDL_vulkan.h"
+#include <algorithm>
 #include <bitset>
+#include <future>
 #include "imgui.h"
 #include "tiny_obj_loader.h"
 #include "backends/imgui_impl_vulkan.h"
@@ -9,12 +11,22 @@
 #include "VkBootstrap.h"
 
 #include "renderer.hpp"
+#include "core/profile/profiler.hpp"
+#include "core/scene/dynamic_bvh.hpp"
 #include "utils/common.hpp"
 #include "creation_helper.hpp"
 #include "builder.hpp"
 
 namespace luna {
 
+// free imgui draw lists cloned into a snapshot
+static void releaseUiDrawLists(RenderSnapshot &snapshot) {
+    for (ImDrawList *drawList : snapshot.uiDrawLists) {
+        IM_DELETE(drawList);
+    }
+    snapshot.uiDrawLists.clear();
+}
+
 bool Renderer::initialise(RenderConfig renderConfig) {
     auto l = SLog::get();
     _renderConf = renderConfig;
@@ -61,6 +73,10 @@ bool Renderer::initialise(RenderConfig renderConfig) {
         return false;
     };
 
+    // from here on every vulkan call is made from render thread
+    _renderThreadRunning = true;
+    _renderThread = std::thread(&Renderer::renderThreadMain, this);
+
     return true;
 }
 
@@ -94,11 +110,15 @@ bool Renderer::initBase() {
     auto l = SLog::get();
     l->debug("initialising base");
 
-    // Create SDL window
-    SDL_Init(SDL_INIT_VIDEO);
-    uint32_t window_flags = SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE;
-    _window = SDL_CreateWindow("Luna's Vulkan Engine", _renderConf.windowWidth,
-                               _renderConf.windowHeight, window_flags);
+    // Create SDL window, headless mode only needs the event subsystem for input
+    if (_renderConf.headless) {
+        SDL_Init(SDL_INIT_EVENTS);
+    } else {
+        SDL_Init(SDL_INIT_VIDEO);
+        uint32_t window_flags = SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE;
+        _window = SDL_CreateWindow("Luna's Vulkan Engine", _renderConf.windowWidth,
+                                   _renderConf.windowHeight, window_flags);
+    }
 
     // Initialise vulkan through bootstrap  ---------------------------------------------
     vkb::InstanceBuilder instBuilder;
@@ -137,6 +157,7 @@ bool Renderer::initBase() {
     auto instBuildRes = instBuilder.set_app_name("Luna Vulkan Engine")
                             .set_engine_name("Luna Engine")
                             .enable_validation_layers(enableValidation)
+                            .set_headless(_renderConf.headless)
                             .require_api_version(1, 3)
                             .build();
 
@@ -156,15 +177,19 @@ bool Renderer::initBase() {
         VK_API_VERSION_MINOR(vkbInst.api_version)));
 
     // Surface (window handle for different os)
-    if (!SDL_Vulkan_CreateSurface(_window, _instance, nullptr, &_surface)) {
+    if (!_renderConf.headless &&
+        !SDL_Vulkan_CreateSurface(_window, _instance, nullptr, &_surface)) {
         l->error("failed to create SDL surface");
         return false;
     }
 
     // Select physical device, same pattern  ---------------------------------------------
+    // headless instance doesn't require a surface, software icd (lavapipe) is accepted
     vkb::PhysicalDeviceSelector physSelector(vkbInst);
-    auto physSelectorBuildRes = physSelector.set_surface(_surface)
-                                    .set_minimum_version(1, 3)
+    if (!_renderConf.headless) {
+        physSelector.set_surface(_surface);
+    }
+    auto physSelectorBuildRes = physSelector.set_minimum_version(1, 3)
                                     .set_required_features(_requiredPhysicalDeviceFeatures)
                                     .add_required_extension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)
                                     .select();
@@ -185,11 +210,65 @@ bool Renderer::initBase() {
         .synchronization2 = VK_TRUE,
     };
 
+    // gpu driven mrt needs multi draw indirect count, gl_DrawID and a bindless texture array,
+    // anything missing keeps the cpu recorded draw path
+    VkPhysicalDeviceVulkan11Features supported11{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+    };
+    VkPhysicalDeviceVulkan12Features supported12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &supported11,
+    };
+    VkPhysicalDeviceFeatures2 supported{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &supported12,
+    };
+    vkGetPhysicalDeviceFeatures2(physDevice.physical_device, &supported);
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+    };
+    VkPhysicalDeviceProperties2 props{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &indexingProps,
+    };
+    vkGetPhysicalDeviceProperties2(physDevice.physical_device, &props);
+    VkPhysicalDeviceFeatures multiDrawFeature{.multiDrawIndirect = VK_TRUE};
+    _gpuDriven = _renderConf.gpuDriven && supported11.shaderDrawParameters &&
+                 supported12.drawIndirectCount && supported12.runtimeDescriptorArray &&
+                 supported12.descriptorBindingPartiallyBound &&
+                 supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                 supported12.shaderSampledImageArrayNonUniformIndexing &&
+                 indexingProps.maxPerStageDescriptorUpdateAfterBindSamplers >=
+                     MAX_BINDLESS_TEXTURES &&
+                 indexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages >=
+                     MAX_BINDLESS_TEXTURES &&
+                 physDevice.enable_features_if_present(multiDrawFeature);
+    l->info(fmt::format("gpu driven rendering: {:s}", _gpuDriven ? "on" : "off"));
+
+    VkPhysicalDeviceVulkan11Features features11{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+    };
+    features11.shaderDrawParameters = _gpuDriven;
+    VkPhysicalDeviceVulkan12Features features12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    };
+    // upload completion is tracked on a timeline semaphore
+    features12.timelineSemaphore = VK_TRUE;
+    features12.drawIndirectCount = _gpuDriven;
+    features12.runtimeDescriptorArray = _gpuDriven;
+    features12.descriptorBindingPartiallyBound = _gpuDriven;
+    features12.descriptorBindingSampledImageUpdateAfterBind = _gpuDriven;
+    features12.shaderSampledImageArrayNonUniformIndexing = _gpuDriven;
+
     // Select logical device, criteria in physical device will automatically propagate to logical
     // device creation
     vkb::DeviceBuilder deviceBuilder{physDevice};
-    vkb::Device vkbDevice =
-        deviceBuilder.add_pNext(&dynRenderFeature).add_pNext(&sync2Feature).build().value();
+    vkb::Device vkbDevice = deviceBuilder.add_pNext(&dynRenderFeature)
+                                .add_pNext(&sync2Feature)
+                                .add_pNext(&features11)
+                                .add_pNext(&features12)
+                                .build()
+                                .value();
 
     // Store results of physical device and logical device
     _gpu = physDevice.physical_device;
@@ -199,8 +278,24 @@ bool Renderer::initBase() {
     // Get queues (bootstrap will enable one queue for each family cuz in practice one is enough)
     _graphicsQueue = vkbDevice.get_queue(vkb::QueueType::graphics).value();
     _graphicsQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
-    _presentsQueue = vkbDevice.get_queue(vkb::QueueType::present).value();
-    _presentsQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::present).value();
+    if (_renderConf.headless) {
+        _presentsQueue = _graphicsQueue;  // never presents
+        _presentsQueueFamily = _graphicsQueueFamily;
+    } else {
+        _presentsQueue = vkbDevice.get_queue(vkb::QueueType::present).value();
+        _presentsQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::present).value();
+    }
+
+    // copies run on a transfer only family when the device exposes one, they overlap rendering
+    auto transferQueue = vkbDevice.get_dedicated_queue(vkb::QueueType::transfer);
+    if (transferQueue) {
+        _transferQueue = transferQueue.value();
+        _transferQueueFamily =
+            vkbDevice.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+    } else {
+        _transferQueue = _graphicsQueue;
+        _transferQueueFamily = _graphicsQueueFamily;
+    }
 
     if (!_graphicsQueue || !_presentsQueue) {
         l->error("Failed to get queue from logical device");
@@ -216,28 +311,32 @@ bool Renderer::initBase() {
 
     // Swapchains, remember you'll need to rebuild swapchain if your window is resized
     // ---------------------------------------------
-    vkb::SwapchainBuilder swapchainBuilder{_gpu, _device, _surface};
-    auto vkbSwapchainRes = swapchainBuilder
-                               .use_default_format_selection()  // B8G8R8A8_SRGB + SRGB non linear
-                               .use_default_present_mode_selection()  // mailbox, falback to fifo
-                               .use_default_image_usage_flags()       // Color attachment
-                               .build();
-
-    if (!vkbSwapchainRes) {
-        l->error(fmt::format("Failed to create swapchain. Error: {:s}",
-                             vkbSwapchainRes.error().message().c_str()));
-        return false;
-    }
+    vkb::Swapchain vkbSwapchain{};
+    if (!_renderConf.headless) {
+        vkb::SwapchainBuilder swapchainBuilder{_gpu, _device, _surface};
+        auto vkbSwapchainRes =
+            swapchainBuilder
+                .use_default_format_selection()        // B8G8R8A8_SRGB + SRGB non linear
+                .use_default_present_mode_selection()  // mailbox, falback to fifo
+                .use_default_image_usage_flags()       // Color attachment
+                .build();
+
+        if (!vkbSwapchainRes) {
+            l->error(fmt::format("Failed to create swapchain. Error: {:s}",
+                                 vkbSwapchainRes.error().message().c_str()));
+            return false;
+        }
 
-    // store swapchain and its related images
-    auto vkbSwapchain = vkbSwapchainRes.value();
-    _swapchain = vkbSwapchain.swapchain;
-    _swapchainImages = vkbSwapchain.get_images().value();
-    _swapChainExtent = vkbSwapchain.extent;
-    // TODO: Fix extent, should query SDL:
-    // https://vulkan-tutorial.com/Drawing_a_triangle/Presentation/Swap_chain
-    _swapchainImageViews = vkbSwapchain.get_image_views().value();
-    _swapchainImageFormat = vkbSwapchain.image_format;
+        // store swapchain and its related images
+        vkbSwapchain = vkbSwapchainRes.value();
+        _swapchain = vkbSwapchain.swapchain;
+        _swapchainImages = vkbSwapchain.get_images().value();
+        _swapChainExtent = vkbSwapchain.extent;
+        // TODO: Fix extent, should query SDL:
+        // https://vulkan-tutorial.com/Drawing_a_triangle/Presentation/Swap_chain
+        _swapchainImageViews = vkbSwapchain.get_image_views().value();
+        _swapchainImageFormat = vkbSwapchain.image_format;
+    }
 
     // VMA Memory ---------------------------------------------
     VmaAllocatorCreateInfo allocatorInfo = {};
@@ -246,6 +345,33 @@ bool Renderer::initBase() {
     allocatorInfo.instance = _instance;
     vmaCreateAllocator(&allocatorInfo, &_allocator);
 
+    // Offscreen images stand in for swapchain images in headless mode
+    if (_renderConf.headless) {
+        _swapchainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        _swapChainExtent = {static_cast<uint32_t>(_renderConf.windowWidth),
+                            static_cast<uint32_t>(_renderConf.windowHeight)};
+        VmaAllocationCreateInfo localAllocInfo{};
+        localAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        localAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        for (int i = 0; i < _renderConf.maxFrameInFlight; ++i) {
+            VkImage image;
+            VkImageView imageView;
+            VmaAllocation allocation;
+            VkImageCreateInfo createImgInfo = CreationHelper::imageCreateInfo(
+                _swapchainImageFormat,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                _swapChainExtent);
+            l->vk_res(vmaCreateImage(_allocator, &createImgInfo, &localAllocInfo, &image,
+                                     &allocation, nullptr));
+            VkImageViewCreateInfo createImgViewInfo = CreationHelper::imageViewCreateInfo(
+                _swapchainImageFormat, image, VK_IMAGE_ASPECT_COLOR_BIT);
+            l->vk_res(vkCreateImageView(_device, &createImgViewInfo, nullptr, &imageView));
+            _swapchainImages.push_back(image);
+            _swapchainImageViews.push_back(imageView);
+            _offscreenAllocations.push_back(allocation);
+        }
+    }
+
     printPhysDeviceProps();
 
     for (int i = 0; i < _renderConf.maxFrameInFlight; ++i) {
@@ -259,30 +385,55 @@ bool Renderer::initBase() {
         }
         _flightResources.clear();
 
-        vmaDestroyAllocator(_allocator);
         for (auto &_swapchainImageView : _swapchainImageViews)
             vkDestroyImageView(_device, _swapchainImageView, nullptr);
+        for (int i = 0; i < _offscreenAllocations.size(); ++i) {
+            vmaDestroyImage(_allocator, _swapchainImages[i], _offscreenAllocations[i]);
+        }
+        vmaDestroyAllocator(_allocator);
 
-        vkb::destroy_swapchain(vkbSwapchain);
+        if (!_renderConf.headless) {
+            vkb::destroy_swapchain(vkbSwapchain);
+        }
         vkb::destroy_device(vkbDevice);
-        vkDestroySurfaceKHR(_instance, _surface, nullptr);
+        if (!_renderConf.headless) {
+            vkDestroySurfaceKHR(_instance, _surface, nullptr);
+        }
         vkb::destroy_instance(vkbInst);
-        SDL_DestroyWindow(_window);
+        if (_window) SDL_DestroyWindow(_window);
     });
 
     return true;
 }
 
 void Renderer::shutdown() {
+    // stop render thread first, it owns the queue and command buffers
+    {
+        std::lock_guard lock(_handoffMutex);
+        _renderThreadStop = true;
+        _isShutdown = true;
+    }
+    _handoffCv.notify_all();
+    if (_renderThread.joinable()) _renderThread.join();
+    _renderThreadRunning = false;
+
     // make sure the gpu has stopped doing its things
     // for (auto &item : _frames)
     for (int i = 0; i < _renderConf.maxFrameInFlight; ++i) {
         vkWaitForFences(_device, 1, &_flightResources[i]->renderFence, true, 1000000000);
     }
     vkDeviceWaitIdle(_device);
+    flushDeferredDelete(true);
+    for (const auto &mesh : _meshList) {
+        destroyMeshInternal(mesh);
+    }
+    _meshList.clear();
+    _modalStateList.clear();
+    releaseUiDrawLists(_pendingSnapshot);
+    releaseUiDrawLists(_renderSnapshot);
 
     // Imgui
-    ImGui_ImplSDL3_Shutdown();
+    if (!_renderConf.headless) ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
 
     while (!_interCleanup.empty()) {
@@ -321,6 +472,7 @@ void Renderer::printPhysDeviceProps() {
     }
     l->debug(fmt::format("\tSelected graphic queue family idx: {:d}", _graphicsQueueFamily));
     l->debug(fmt::format("\tSelected present queue family idx: {:d}", _presentsQueueFamily));
+    l->debug(fmt::format("\tSelected transfer queue family idx: {:d}", _transferQueueFamily));
     l->debug(fmt::format("\tWindow extent: {:d}, {:d}", _renderConf.windowWidth,
                          _renderConf.windowWidth));
     l->debug(fmt::format("\tSwapchain extent: {:d}, {:d}", _swapChainExtent.width,
@@ -334,27 +486,35 @@ bool Renderer::initCommand() {
     auto l = SLog::get();
     l->debug("initialising command buffer");
 
-    // Create one time pool and long time pool
+    // pool for reusable per frame buffers, uploads record into their own batches
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     poolInfo.queueFamilyIndex = _graphicsQueueFamily;
 
-    // create pool suitable for reusing buffer and another one for one time buffer
     if (vkCreateCommandPool(_device, &poolInfo, nullptr, &_renderCmdPool) != VK_SUCCESS) {
         l->error("Failed to create command pool");
         return false;
     }
-    poolInfo.flags = 0;
-    if (vkCreateCommandPool(_device, &poolInfo, nullptr, &_oneTimeCmdPool) != VK_SUCCESS) {
-        l->error("Failed to create one time command pool");
+    if (!_uploads.initialise(_device, _allocator, _transferQueue, _transferQueueFamily,
+                             _graphicsQueueFamily,
+                             static_cast<VkDeviceSize>(_renderConf.stagingRingMb) << 20)) {
+        return false;
+    }
+    // every mesh lives in these two buffers, the mrt pass binds them once
+    if (!_vertexArena.initialise(_allocator, _uploads, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                 sizeof(Vertex), GEOMETRY_INITIAL_VERTICES) ||
+        !_indexArena.initialise(_allocator, _uploads, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                sizeof(uint32_t), GEOMETRY_INITIAL_INDICES)) {
         return false;
     }
 
     // Command buffer is implicitly deleted when pool is destroyed
     _globCleanup.emplace([this]() {
+        _vertexArena.shutdown();
+        _indexArena.shutdown();
+        _uploads.shutdown();
         vkDestroyCommandPool(_device, _renderCmdPool, nullptr);
-        vkDestroyCommandPool(_device, _oneTimeCmdPool, nullptr);
     });
 
     // Create command buffer for submitting rendering work
@@ -504,8 +664,27 @@ bool Renderer::initSync() {
         }
     }
 
+    // timestamp queries for gpu pass timing, optional
+    _timestampSupported = _gpuProperties.limits.timestampComputeAndGraphics == VK_TRUE;
+    _timestampPeriodNs = _gpuProperties.limits.timestampPeriod;
+    if (_timestampSupported) {
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = GPU_TIMESTAMP_COUNT;
+        for (int i = 0; i < _renderConf.maxFrameInFlight; ++i) {
+            l->vk_res(vkCreateQueryPool(_device, &queryPoolInfo, nullptr,
+                                        &_flightResources[i]->timestampPool));
+        }
+    } else {
+        l->warn("gpu doesn't support timestamp on graphic queue, gpu timing disabled");
+    }
+
     _globCleanup.emplace([this]() {
         for (int i = 0; i < _renderConf.maxFrameInFlight; ++i) {
+            if (_flightResources[i]->timestampPool) {
+                vkDestroyQueryPool(_device, _flightResources[i]->timestampPool, nullptr);
+            }
             vkDestroyFence(_device, _flightResources[i]->renderFence, nullptr);
             vkDestroySemaphore(_device, _flightResources[i]->mrtSemaphore, nullptr);
             vkDestroySemaphore(_device, _flightResources[i]->compSemaphore, nullptr);
@@ -524,6 +703,7 @@ bool Renderer::initDescriptors() {
     std::vector<VkDescriptorPoolSize> sizes = {
         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 200},
         {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 200},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 200},
     };
     VkDescriptorPoolCreateInfo pool_info = {};
     pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -581,6 +761,197 @@ bool Renderer::initDescriptors() {
         }
     });
 
+    // per flight instance (and cull) buffers are created by the first frame using them
+    _globCleanup.emplace([this]() {
+        for (FlightResource *flight : _flightResources) {
+            for (BufferResource *buf :
+                 {&flight->instanceBuffer, &flight->batchBuffer, &flight->drawBuffer,
+                  &flight->commandBuffer, &flight->countBuffer, &flight->visibleDrawBuffer,
+                  &flight->visibleInstanceBuffer}) {
+                vmaDestroyBuffer(_allocator, buf->buffer, buf->allocation);
+            }
+        }
+    });
+
+    if (!_gpuDriven) return true;
+
+    // Gpu driven cull lists, set 0 of both cull and indirect mrt pipeline
+    // ------------------------------------------------------------------------
+    l->debug("init gpu driven set resource");
+    const VkShaderStageFlags cullAndVertex =
+        VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    DescriptorBuilder cullSetBuilder(_device, _globalDescPool);
+    cullSetBuilder.setTotalSet(1);
+    cullSetBuilder.pushDefaultStorageBuffer(0, cullAndVertex);                // instances
+    cullSetBuilder.pushDefaultStorageBuffer(0, cullAndVertex);                // batches
+    cullSetBuilder.pushDefaultStorageBuffer(0, cullAndVertex);                // draws
+    cullSetBuilder.pushDefaultStorageBuffer(0, VK_SHADER_STAGE_COMPUTE_BIT);  // commands
+    cullSetBuilder.pushDefaultStorageBuffer(0, VK_SHADER_STAGE_COMPUTE_BIT);  // counts
+    cullSetBuilder.pushDefaultStorageBuffer(0, cullAndVertex);                // visible draws
+    cullSetBuilder.pushDefaultStorageBuffer(0, cullAndVertex);                // visible instances
+    _cullSetLayout = cullSetBuilder.buildSetLayout(0);
+    // buffers are written by reserveFrameBuffers, again whenever they grow
+    for (int i = 0; i < _renderConf.maxFrameInFlight; ++i) {
+        _flightResources[i]->cullDescSet = cullSetBuilder.buildSet(0);
+    }
+
+    // Bindless materials and textures, slots are written as materials are created
+    // ------------------------------------------------------------------------
+    std::array<VkDescriptorSetLayoutBinding, 2> bindlessBindings{};
+    bindlessBindings[0].binding = 0;
+    bindlessBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindlessBindings[0].descriptorCount = 1;
+    bindlessBindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindlessBindings[1].binding = 1;
+    bindlessBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindlessBindings[1].descriptorCount = MAX_BINDLESS_TEXTURES;
+    bindlessBindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    // unused slots are never sampled, new ones are written while earlier frames are in flight
+    std::array<VkDescriptorBindingFlags, 2> bindlessFlags = {
+        0, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+               VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT};
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = bindlessFlags.size();
+    bindingFlagsInfo.pBindingFlags = bindlessFlags.data();
+    VkDescriptorSetLayoutCreateInfo bindlessLayoutInfo{};
+    bindlessLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    bindlessLayoutInfo.pNext = &bindingFlagsInfo;
+    bindlessLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    bindlessLayoutInfo.bindingCount = bindlessBindings.size();
+    bindlessLayoutInfo.pBindings = bindlessBindings.data();
+    l->vk_res(vkCreateDescriptorSetLayout(_device, &bindlessLayoutInfo, nullptr,
+                                          &_bindlessSetLayout));
+
+    std::vector<VkDescriptorPoolSize> bindlessSizes = {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_BINDLESS_TEXTURES},
+    };
+    VkDescriptorPoolCreateInfo bindlessPoolInfo = {};
+    bindlessPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    bindlessPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    bindlessPoolInfo.maxSets = 1;
+    bindlessPoolInfo.poolSizeCount = (uint32_t)bindlessSizes.size();
+    bindlessPoolInfo.pPoolSizes = bindlessSizes.data();
+    l->vk_res(vkCreateDescriptorPool(_device, &bindlessPoolInfo, nullptr, &_bindlessDescPool));
+
+    DescriptorBuilder bindlessSetBuilder(_device, _bindlessDescPool);
+    bindlessSetBuilder.setTotalSet(1).setSetLayout(0, _bindlessSetLayout);
+    _bindlessSet = bindlessSetBuilder.buildSet(0);
+
+    if (CreationHelper::createStorageBuffer(_allocator,
+                                            sizeof(GpuMaterialData) * MAX_BINDLESS_MATERIALS, 0,
+                                            true, _materialBuffer) != VK_SUCCESS) {
+        l->error("failed to create bindless material buffer");
+        return false;
+    }
+    VkDescriptorBufferInfo materialBufferInfo{_materialBuffer.buffer, 0, VK_WHOLE_SIZE};
+    VkWriteDescriptorSet materialWrite{};
+    materialWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    materialWrite.dstSet = _bindlessSet;
+    materialWrite.dstBinding = 0;
+    materialWrite.descriptorCount = 1;
+    materialWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    materialWrite.pBufferInfo = &materialBufferInfo;
+    vkUpdateDescriptorSets(_device, 1, &materialWrite, 0, nullptr);
+
+    _globCleanup.emplace([this]() {
+        vmaDestroyBuffer(_allocator, _materialBuffer.buffer, _materialBuffer.allocation);
+        vkDestroyDescriptorPool(_device, _bindlessDescPool, nullptr);
+        vkDestroyDescriptorSetLayout(_device, _bindlessSetLayout, nullptr);
+        vkDestroyDescriptorSetLayout(_device, _cullSetLayout, nullptr);
+    });
+
+    return true;
+}
+
+bool Renderer::reserveFrameBuffers(FlightResource &flight, uint32_t instanceCount,
+                                   uint32_t batchCount, uint32_t drawCount) {
+    auto l = SLog::get();
+    // the flight fence is waited, nothing on the gpu reads this flight's buffers
+    auto recreate = [this](std::initializer_list<BufferResource *> buffers) {
+        for (BufferResource *buf : buffers) {
+            vmaDestroyBuffer(_allocator, buf->buffer, buf->allocation);
+            *buf = {};
+        }
+    };
+    auto grow = [](uint32_t needed, uint32_t capacity) {
+        return std::max({needed, capacity * 2, FRAME_INITIAL_INSTANCES});
+    };
+    bool rebuilt = false;
+    if (instanceCount > flight.instanceCapacity || flight.instanceBuffer.buffer == VK_NULL_HANDLE) {
+        uint32_t capacity = grow(instanceCount, flight.instanceCapacity);
+        recreate({&flight.instanceBuffer, &flight.visibleInstanceBuffer});
+        flight.instanceCapacity = 0;
+        if (CreationHelper::createStorageBuffer(
+                _allocator, sizeof(GpuInstanceData) * capacity,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, true, flight.instanceBuffer) != VK_SUCCESS ||
+            (_gpuDriven &&
+             CreationHelper::createStorageBuffer(_allocator, sizeof(uint32_t) * capacity, 0, false,
+                                                 flight.visibleInstanceBuffer) != VK_SUCCESS)) {
+            l->error(fmt::format("failed to create instance buffers ({:d})", capacity));
+            return false;
+        }
+        flight.instanceCapacity = capacity;
+        rebuilt = true;
+    }
+    if (!_gpuDriven) return true;
+
+    if (batchCount > flight.batchCapacity || flight.batchBuffer.buffer == VK_NULL_HANDLE) {
+        uint32_t capacity = grow(batchCount, flight.batchCapacity);
+        recreate({&flight.batchBuffer, &flight.countBuffer});
+        flight.batchCapacity = 0;
+        if (CreationHelper::createStorageBuffer(_allocator, sizeof(GpuBatchData) * capacity, 0,
+                                                true, flight.batchBuffer) != VK_SUCCESS ||
+            CreationHelper::createStorageBuffer(
+                _allocator, sizeof(uint32_t) * (capacity + 1),
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, false,
+                flight.countBuffer) != VK_SUCCESS) {
+            l->error(fmt::format("failed to create cull batch buffers ({:d})", capacity));
+            return false;
+        }
+        flight.batchCapacity = capacity;
+        rebuilt = true;
+    }
+    if (drawCount > flight.drawCapacity || flight.drawBuffer.buffer == VK_NULL_HANDLE) {
+        uint32_t capacity = grow(drawCount, flight.drawCapacity);
+        recreate({&flight.drawBuffer, &flight.commandBuffer, &flight.visibleDrawBuffer});
+        flight.drawCapacity = 0;
+        if (CreationHelper::createStorageBuffer(_allocator, sizeof(GpuDrawData) * capacity, 0,
+                                                true, flight.drawBuffer) != VK_SUCCESS ||
+            CreationHelper::createStorageBuffer(
+                _allocator, sizeof(VkDrawIndexedIndirectCommand) * capacity,
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false, flight.commandBuffer) != VK_SUCCESS ||
+            CreationHelper::createStorageBuffer(_allocator, sizeof(uint32_t) * capacity, 0, false,
+                                                flight.visibleDrawBuffer) != VK_SUCCESS) {
+            l->error(fmt::format("failed to create cull draw buffers ({:d})", capacity));
+            return false;
+        }
+        flight.drawCapacity = capacity;
+        rebuilt = true;
+    }
+    if (!rebuilt) return true;
+
+    // binding order matches cull.comp
+    std::array<VkDescriptorBufferInfo, 7> bufferInfos = {{
+        {flight.instanceBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {flight.batchBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {flight.drawBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {flight.commandBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {flight.countBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {flight.visibleDrawBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {flight.visibleInstanceBuffer.buffer, 0, VK_WHOLE_SIZE},
+    }};
+    std::array<VkWriteDescriptorSet, 7> writes{};
+    for (uint32_t i = 0; i < writes.size(); ++i) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = flight.cullDescSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(_device, writes.size(), writes.data(), 0, nullptr);
     return true;
 }
 
@@ -620,9 +991,13 @@ bool Renderer::initPipeline() {
     // Pipeline data to be filled
     VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
 
-    // vertex input
+    // vertex input, per vertex data then the per instance transform
     auto bindingDescription = Vertex::getBindingDescription();
     auto attributeDescription = Vertex::getAttributeDescriptions();
+    auto instanceAttributeDescription = GpuInstanceData::getAttributeDescriptions();
+    bindingDescription.push_back(GpuInstanceData::getBindingDescription());
+    attributeDescription.insert(attributeDescription.end(), instanceAttributeDescription.begin(),
+                                instanceAttributeDescription.end());
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount = bindingDescription.size();
@@ -683,6 +1058,84 @@ bool Renderer::initPipeline() {
     vkDestroyShaderModule(_device, mrtVertShaderModule, nullptr);
     vkDestroyShaderModule(_device, mrtFragShaderModule, nullptr);
 
+    // Gpu driven MRT and cull pipeline ---------------------------------------------
+    if (_gpuDriven) {
+        // same fixed function state as mrt, per draw data comes from storage buffers
+        std::vector<char> indirectVertShaderCode =
+            CreationHelper::readFile("assets/shaders/mrt_indirect.vert.spv");
+        std::vector<char> indirectFragShaderCode =
+            CreationHelper::readFile("assets/shaders/mrt_indirect.frag.spv");
+        VkShaderModule indirectVertShaderModule =
+            CreationHelper::createShaderModule(indirectVertShaderCode, _device);
+        VkShaderModule indirectFragShaderModule =
+            CreationHelper::createShaderModule(indirectFragShaderCode, _device);
+        shaderStages[0].module = indirectVertShaderModule;
+        shaderStages[1].module = indirectFragShaderModule;
+        // instances are read from storage buffers, only the vertex binding is left
+        auto indirectBindingDescription = Vertex::getBindingDescription();
+        auto indirectAttributeDescription = Vertex::getAttributeDescriptions();
+        vertexInputInfo.vertexBindingDescriptionCount = indirectBindingDescription.size();
+        vertexInputInfo.pVertexBindingDescriptions = indirectBindingDescription.data();
+        vertexInputInfo.vertexAttributeDescriptionCount = indirectAttributeDescription.size();
+        vertexInputInfo.pVertexAttributeDescriptions = indirectAttributeDescription.data();
+
+        VkPushConstantRange indirectPushRange{};
+        indirectPushRange.size = sizeof(MrtPushConstantData);
+        indirectPushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        std::array<VkDescriptorSetLayout, 2> indirectSetLayouts = {_cullSetLayout,
+                                                                   _bindlessSetLayout};
+        VkPipelineLayoutCreateInfo indirectLayoutInfo{};
+        indirectLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        indirectLayoutInfo.pushConstantRangeCount = 1;
+        indirectLayoutInfo.pPushConstantRanges = &indirectPushRange;
+        indirectLayoutInfo.setLayoutCount = indirectSetLayouts.size();
+        indirectLayoutInfo.pSetLayouts = indirectSetLayouts.data();
+        if (vkCreatePipelineLayout(_device, &indirectLayoutInfo, nullptr,
+                                   &_mrtIndirectPipelineLayout) != VK_SUCCESS) {
+            l->error("failed to create indirect mrt pipeline layout");
+            return false;
+        }
+        pipelineCreateInfo.layout = _mrtIndirectPipelineLayout;
+        CreationHelper::fillAndCreateGPipeline(pipelineCreateInfo, _mrtIndirectPipeline, _device,
+                                               _swapChainExtent, MRT_OUT_SIZE - 1);
+        vkDestroyShaderModule(_device, indirectVertShaderModule, nullptr);
+        vkDestroyShaderModule(_device, indirectFragShaderModule, nullptr);
+
+        // frustum cull, writes the indirect commands
+        std::vector<char> cullShaderCode = CreationHelper::readFile("assets/shaders/cull.comp.spv");
+        VkShaderModule cullShaderModule =
+            CreationHelper::createShaderModule(cullShaderCode, _device);
+
+        VkPushConstantRange cullPushRange{};
+        cullPushRange.size = sizeof(CullPushConstantData);
+        cullPushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        VkPipelineLayoutCreateInfo cullLayoutInfo{};
+        cullLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        cullLayoutInfo.pushConstantRangeCount = 1;
+        cullLayoutInfo.pPushConstantRanges = &cullPushRange;
+        cullLayoutInfo.setLayoutCount = 1;
+        cullLayoutInfo.pSetLayouts = &_cullSetLayout;
+        if (vkCreatePipelineLayout(_device, &cullLayoutInfo, nullptr, &_cullPipelineLayout) !=
+            VK_SUCCESS) {
+            l->error("failed to create cull pipeline layout");
+            return false;
+        }
+
+        VkComputePipelineCreateInfo cullPipelineInfo{};
+        cullPipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        cullPipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        cullPipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        cullPipelineInfo.stage.module = cullShaderModule;
+        cullPipelineInfo.stage.pName = "main";
+        cullPipelineInfo.layout = _cullPipelineLayout;
+        if (vkCreateComputePipelines(_device, VK_NULL_HANDLE, 1, &cullPipelineInfo, nullptr,
+                                     &_cullPipeline) != VK_SUCCESS) {
+            l->error("failed to create cull pipeline");
+            return false;
+        }
+        vkDestroyShaderModule(_device, cullShaderModule, nullptr);
+    }
+
     // Composition pipeline --------------------------------------------------------
 
     std::vector<char> compVertShaderCode =
@@ -746,12 +1199,36 @@ bool Renderer::initPipeline() {
         vkDestroyPipeline(_device, _mrtPipeline, nullptr);
         vkDestroyPipelineLayout(_device, _compPipelineLayout, nullptr);
         vkDestroyPipeline(_device, _compPipeline, nullptr);
+        vkDestroyPipelineLayout(_device, _mrtIndirectPipelineLayout, nullptr);
+        vkDestroyPipeline(_device, _mrtIndirectPipeline, nullptr);
+        vkDestroyPipelineLayout(_device, _cullPipelineLayout, nullptr);
+        vkDestroyPipeline(_device, _cullPipeline, nullptr);
     });
 
     return true;
 }
 
 int Renderer::createMaterial(MaterialCpu &materialCpu) {
+    // id is handed out here, the gpu material is created before any snapshot that can use it,
+    // caller frees texture data on return so the pixels travel with the command
+    int matId = _nextMatId++;
+    auto pixels = std::make_shared<std::array<std::vector<unsigned char>, 3>>();
+    MaterialCpu material = materialCpu;
+    std::array<TextureData *, 3> textures = {&material.albedoTexture, &material.normalTexture,
+                                             &material.aoRoughnessHeightTexture};
+    for (size_t i = 0; i < textures.size(); i++) {
+        TextureData &tex = *textures[i];
+        if (tex.data == nullptr) continue;
+        size_t size = static_cast<size_t>(tex.texWidth) * tex.texHeight * tex.texChannels;
+        (*pixels)[i].assign(tex.data, tex.data + size);
+        tex.data = (*pixels)[i].data();
+    }
+    enqueueRenderCmd(
+        [this, material, matId, pixels]() { createMaterialInternal(material, matId); });
+    return matId;
+}
+
+void Renderer::createMaterialInternal(const MaterialCpu &materialCpu, int matId) {
     auto l = SLog::get();
     std::shared_ptr<MaterialGpu> gpuMaterial = std::make_shared<MaterialGpu>();
 
@@ -796,136 +1273,226 @@ int Renderer::createMaterial(MaterialCpu &materialCpu) {
 
     gpuMaterial->uboData = materialCpu.info;
     gpuMaterial->descriptorSet = mrtSetBuilder.buildSet(0);
+    if (_gpuDriven) writeBindlessMaterial(*gpuMaterial);
 
-    _materialMap[_nextMatId] = gpuMaterial;
-    return _nextMatId++;
+    _materialMap[matId] = gpuMaterial;
 }
 
-std::shared_ptr<ModalState> Renderer::uploadModel(ModelDataCpu &modelData) {
-    std::shared_ptr<ModalState> newModalState = std::make_shared<ModalState>();
+// free slot or the next unused one, UINT32_MAX once the table is full
+static uint32_t takeSlot(std::vector<uint32_t> &freeSlots, uint32_t &nextSlot, uint32_t maxSlot) {
+    if (!freeSlots.empty()) {
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    return nextSlot < maxSlot ? nextSlot++ : UINT32_MAX;
+}
 
+void Renderer::writeBindlessMaterial(MaterialGpu &material) {
     auto l = SLog::get();
-    // VMA best usage info:
-    // https://gpuopen-librariesandsdks.github.io/VulkanMemoryAllocator/html/usage_patterns.html
-    // Buffer info
-    VkBufferCreateInfo stagingBufferInfo{};
-    stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    stagingBufferInfo.size = sizeof(Vertex) * modelData.vertex.size();
-    stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    stagingBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VkBufferCreateInfo gpuBufferInfo = stagingBufferInfo;
-    gpuBufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    material.materialSlot =
+        takeSlot(_freeMaterialSlots, _nextMaterialSlot, MAX_BINDLESS_MATERIALS);
+    if (material.materialSlot == UINT32_MAX) {
+        l->error("bindless material table is full, material is not drawn");
+        return;
+    }
 
-    l->debug(fmt::format("copy vertex buffer to gpu (size: {:d}, total: {:d}, indices: {:d})",
-                         sizeof(Vertex), modelData.vertex.size(), modelData.indices.size()));
+    // slots are only reused after deferred delete, no frame in flight samples a written slot
+    std::array<const ImgResource *, 3> textures = {&material.albedoTex, &material.normalTex,
+                                                   &material.aoRoughnessHeight};
+    std::array<VkDescriptorImageInfo, 3> imageInfos{};
+    std::vector<VkWriteDescriptorSet> writes;
+    for (size_t i = 0; i < textures.size(); i++) {
+        if (!textures[i]->inuse) continue;
+        material.textureSlots[i] =
+            takeSlot(_freeTextureSlots, _nextTextureSlot, MAX_BINDLESS_TEXTURES);
+        if (material.textureSlots[i] == UINT32_MAX) {
+            l->error("bindless texture table is full, texture is not sampled");
+            continue;
+        }
+        imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[i].imageView = textures[i]->imageView;
+        imageInfos[i].sampler = textures[i]->sampler;
+
+        VkWriteDescriptorSet setWrite{};
+        setWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        setWrite.dstSet = _bindlessSet;
+        setWrite.dstBinding = 1;
+        setWrite.dstArrayElement = material.textureSlots[i];
+        setWrite.descriptorCount = 1;
+        setWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        setWrite.pImageInfo = &imageInfos[i];
+        writes.push_back(setWrite);
+    }
+    vkUpdateDescriptorSets(_device, writes.size(), writes.data(), 0, nullptr);
+
+    // a texture without a slot falls back to the flat color
+    GpuMaterialData data{};
+    data.diffuse = material.uboData.diffuse;
+    data.emissive = material.uboData.emissive;
+    data.textureToggle = material.uboData.textureToggle;
+    if (material.textureSlots[0] == UINT32_MAX) data.textureToggle &= ~0b1;
+    if (material.textureSlots[1] == UINT32_MAX) data.textureToggle &= ~0b10;
+    data.albedoSlot = material.textureSlots[0];
+    data.normalSlot = material.textureSlots[1];
+    data.aoRoughnessHeightSlot = material.textureSlots[2];
+    memcpy(static_cast<GpuMaterialData *>(_materialBuffer.allocInfo.pMappedData) +
+               material.materialSlot,
+           &data, sizeof(GpuMaterialData));
+}
 
-    // Memory info, must have VMA_ALLOCATION_CREATE_MAPPED_BIT to create persistent map area so we
-    // can avoid map / unmap memory
-    VmaAllocationCreateInfo stagingAllocInfo{};
-    stagingAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;  // vma way texBufferInfo doing stuff, read doc!
-    stagingAllocInfo.flags =
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-    stagingAllocInfo.preferredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;  // to avoid flushing
-
-    VmaAllocationCreateInfo dstAllocInfo{};
-    dstAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    dstAllocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-    dstAllocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-    VmaAllocation stagingAllocation;  // represent underlying memory
-    VmaAllocationInfo
-        stagingAllocationInfo;  // for persistent mapping:
-                                // https://gpuopen-librariesandsdks.github.io/VulkanMemoryAllocator/html/memory_mapping.html
-    VkBuffer stagingBuffer;
-    l->vk_res(vmaCreateBuffer(_allocator, &stagingBufferInfo, &stagingAllocInfo, &stagingBuffer,
-                              &stagingAllocation, &stagingAllocationInfo));
-
-    // Copy vertex data to staging buffer physical memory
-    memcpy(stagingAllocationInfo.pMappedData, modelData.vertex.data(), stagingBufferInfo.size);
-    // TODO: Check stagingAllocationInfo.memoryType for VK_MEMORY_PROPERTY_HOST_COHERENT_BIT to
-    // avoid flushing all
-    // https://stackoverflow.com/questions/44366839/meaning-of-memorytypes-in-vulkan
-    vmaFlushAllocation(_allocator, stagingAllocation, 0,
-                       stagingBufferInfo.size);  // TODO: Transfer to destination buffer
-    // Flush for VK_MEMORY_PROPERTY_HOST_COHERENT_BIT:
-    // https://gpuopen-librariesandsdks.github.io/VulkanMemoryAllocator/html/memory_mapping.html
-
-    // transfer and free
-    l->vk_res(vmaCreateBuffer(_allocator, &gpuBufferInfo, &dstAllocInfo, &newModalState->vBuffer,
-                              &newModalState->vAllocation, &stagingAllocationInfo));
-    copyBuffer(stagingBuffer, newModalState->vBuffer, sizeof(Vertex) * modelData.vertex.size());
-    vmaDestroyBuffer(_allocator, stagingBuffer, stagingAllocation);
-
-    // Buffer info
-    stagingBufferInfo.size = sizeof(modelData.indices[0]) * modelData.indices.size();
-    gpuBufferInfo.size = sizeof(modelData.indices[0]) * modelData.indices.size();
-    gpuBufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-    l->vk_res(vmaCreateBuffer(_allocator, &stagingBufferInfo, &stagingAllocInfo, &stagingBuffer,
-                              &stagingAllocation, &stagingAllocationInfo));
-    memcpy(stagingAllocationInfo.pMappedData, modelData.indices.data(), stagingBufferInfo.size);
-    vmaFlushAllocation(_allocator, stagingAllocation, 0,
-                       stagingBufferInfo.size);  // TODO: Transfer to destination buffer
-
-    // transfer and free
-    l->vk_res(vmaCreateBuffer(_allocator, &gpuBufferInfo, &dstAllocInfo, &newModalState->iBuffer,
-                              &newModalState->iAllocation, &stagingAllocationInfo));
-    copyBuffer(stagingBuffer, newModalState->iBuffer,
-               sizeof(modelData.indices[0]) * modelData.indices.size());
-    vmaDestroyBuffer(_allocator, stagingBuffer, stagingAllocation);
-
-    // update modal state
-    newModalState->indicesSize = modelData.indices.size();
-    newModalState->modelDataPartition = modelData.modelDataPartition;
+void Renderer::releaseBindlessMaterial(const MaterialGpu &material) {
+    if (material.materialSlot != UINT32_MAX) _freeMaterialSlots.push_back(material.materialSlot);
+    for (uint32_t slot : material.textureSlots) {
+        if (slot != UINT32_MAX) _freeTextureSlots.push_back(slot);
+    }
+}
 
-    _modalStateList.push_back(newModalState);
+std::shared_ptr<MeshGpu> Renderer::uploadMesh(ModelDataCpu &modelData) {
+    // cpu side state is known now, buffers are filled on render thread
+    std::shared_ptr<MeshGpu> newMesh = std::make_shared<MeshGpu>();
+    newMesh->indicesSize = modelData.indices.size();
+    newMesh->modelDataPartition = modelData.modelDataPartition;
+    if (!modelData.vertex.empty()) {
+        newMesh->boundsMin = newMesh->boundsMax = modelData.vertex[0].pos;
+        for (const Vertex &v : modelData.vertex) {
+            newMesh->boundsMin = glm::min(newMesh->boundsMin, v.pos);
+            newMesh->boundsMax = glm::max(newMesh->boundsMax, v.pos);
+        }
+    }
+    auto data = std::make_shared<ModelDataCpu>(std::move(modelData));
+    enqueueRenderCmd([this, newMesh, data]() { uploadMeshInternal(*newMesh, *data); });
+    _meshList.push_back(newMesh);
+    return newMesh;
+}
 
+std::shared_ptr<ModalState> Renderer::addModal(const std::shared_ptr<MeshGpu> &mesh) {
+    if (mesh == nullptr) return nullptr;
+    auto newModalState = std::make_shared<ModalState>();
+    newModalState->mesh = mesh;
+    newModalState->listIdx = static_cast<uint32_t>(_modalStateList.size());
+    _modalStateList.push_back(newModalState);
     return newModalState;
 }
 
+void Renderer::uploadMeshInternal(MeshGpu &mesh, const ModelDataCpu &modelData) {
+    auto l = SLog::get();
+    l->debug(fmt::format("copy vertex buffer to gpu (size: {:d}, total: {:d}, indices: {:d})",
+                         sizeof(Vertex), modelData.vertex.size(), modelData.indices.size()));
+
+    // ranges in the shared arenas, indices stay relative to the mesh first vertex
+    mesh.vertexRange = _vertexArena.allocate(static_cast<uint32_t>(modelData.vertex.size()));
+    mesh.indexRange = _indexArena.allocate(static_cast<uint32_t>(modelData.indices.size()));
+    if (mesh.vertexRange == GEOMETRY_NULL_RANGE || mesh.indexRange == GEOMETRY_NULL_RANGE) {
+        l->error("out of geometry memory, mesh is not drawn");
+        return;
+    }
+    _uploads.uploadBuffer(modelData.vertex.data(), sizeof(Vertex) * modelData.vertex.size(),
+                          _vertexArena.getBuffer(), _vertexArena.getByteOffset(mesh.vertexRange));
+    _uploads.uploadBuffer(modelData.indices.data(),
+                          sizeof(modelData.indices[0]) * modelData.indices.size(),
+                          _indexArena.getBuffer(), _indexArena.getByteOffset(mesh.indexRange));
+}
+
 void Renderer::removeModal(const std::shared_ptr<ModalState> &modalState) {
+    uint32_t idx = modalState->listIdx;
+    if (idx >= _modalStateList.size() || _modalStateList[idx] != modalState) {
+        return;
+    }
+    // swap remove, draw order doesn't matter
+    if (idx + 1 != _modalStateList.size()) {
+        _modalStateList[idx] = std::move(_modalStateList.back());
+        _modalStateList[idx]->listIdx = idx;
+    }
+    _modalStateList.pop_back();
+}
+
+void Renderer::releaseUnusedMeshes() {
+    // snapshots only hold raw pointers, a mesh referenced by nothing but this list is unused
+    for (size_t i = 0; i < _meshList.size();) {
+        if (_meshList[i].use_count() > 1) {
+            i++;
+            continue;
+        }
+        std::shared_ptr<MeshGpu> mesh = std::move(_meshList[i]);
+        _meshList[i] = std::move(_meshList.back());
+        _meshList.pop_back();
+        // snapshots already published may still draw it, defer until they are retired
+        enqueueRenderCmd([this, mesh]() {
+            _deferredDelete.emplace_back(_renderFrameCount,
+                                         [this, mesh]() { destroyMeshInternal(mesh); });
+        });
+    }
+}
+
+void Renderer::destroyMeshInternal(const std::shared_ptr<MeshGpu> &mesh) {
     auto l = SLog::get();
-    auto iter = std::find(_modalStateList.begin(), _modalStateList.end(), modalState);
-    if (iter != _modalStateList.end()) {
-        l->debug("removing modal & materials");
-        _modalStateList.erase(iter);
-        // remove model data
-        vmaDestroyBuffer(_allocator, modalState->vBuffer, modalState->vAllocation);
-        vmaDestroyBuffer(_allocator, modalState->iBuffer, modalState->iAllocation);
-        // delete all materials data
-        for (const auto &modalDataPart : modalState->modelDataPartition) {
-            if (!_materialMap.contains(modalDataPart.materialId)) {
-                continue;
+    l->debug("removing mesh & materials");
+    // give the geometry back, pack the arenas once holes pile up (not worth it on teardown)
+    if (mesh->vertexRange != GEOMETRY_NULL_RANGE) _vertexArena.free(mesh->vertexRange);
+    if (mesh->indexRange != GEOMETRY_NULL_RANGE) _indexArena.free(mesh->indexRange);
+    if (!_isShutdown) {
+        _vertexArena.compactIfFragmented();
+        _indexArena.compactIfFragmented();
+    }
+    // delete all materials data, default material (0) is shared by every mesh
+    for (const auto &modalDataPart : mesh->modelDataPartition) {
+        if (modalDataPart.materialId == 0 || !_materialMap.contains(modalDataPart.materialId)) {
+            continue;
+        }
+        const auto mat = _materialMap[modalDataPart.materialId];
+        _materialMap.erase(modalDataPart.materialId);
+        // remove image sampler resource
+        std::function<void(ImgResource &)> delImgIfUsed = [&](ImgResource &img) {
+            if (img.inuse) {
+                vkDestroySampler(_device, img.sampler, nullptr);
+                vkDestroyImageView(_device, img.imageView, nullptr);
+                vmaDestroyImage(_allocator, img.image, img.allocation);
             }
-            const auto mat = _materialMap[modalDataPart.materialId];
-            _materialMap.erase(modalDataPart.materialId);
-            // remove image sampler resource
-            std::function<void(ImgResource &)> delImgIfUsed = [&](ImgResource &img) {
-                if (img.inuse) {
-                    vkDestroySampler(_device, img.sampler, nullptr);
-                    vkDestroyImageView(_device, img.imageView, nullptr);
-                    vmaDestroyImage(_allocator, img.image, img.allocation);
-                }
-            };
-            delImgIfUsed(mat->albedoTex);
-            delImgIfUsed(mat->normalTex);
-            delImgIfUsed(mat->aoRoughnessHeight);
-            vkFreeDescriptorSets(_device, _globalDescPool, 1, &mat->descriptorSet);
-            vmaDestroyBuffer(_allocator, mat->uniformBuffer, mat->uniformAlloc);
+        };
+        delImgIfUsed(mat->albedoTex);
+        delImgIfUsed(mat->normalTex);
+        delImgIfUsed(mat->aoRoughnessHeight);
+        vkFreeDescriptorSets(_device, _globalDescPool, 1, &mat->descriptorSet);
+        releaseBindlessMaterial(*mat);
+        vmaDestroyBuffer(_allocator, mat->uniformBuffer, mat->uniformAlloc);
+    }
+}
+
+void Renderer::retireGeometryBuffers() {
+    for (GeometryArena *arena : {&_vertexArena, &_indexArena}) {
+        for (auto [buffer, allocation] : arena->takeRetired()) {
+            _deferredDelete.emplace_back(_renderFrameCount, [this, buffer, allocation]() {
+                vmaDestroyBuffer(_allocator, buffer, allocation);
+            });
+        }
+    }
+}
+
+void Renderer::flushDeferredDelete(bool force) {
+    // a snapshot can still be pending when the request is queued, after that every flight slot
+    // has to wrap around once before the gpu is guaranteed done with it
+    const uint64_t retireAfter = _renderConf.maxFrameInFlight + 1;
+    for (auto iter = _deferredDelete.begin(); iter != _deferredDelete.end();) {
+        if (force || _renderFrameCount - iter->first > retireAfter) {
+            iter->second();
+            iter = _deferredDelete.erase(iter);
+        } else {
+            ++iter;
         }
     }
 }
 
 void Renderer::setLightInfo(const glm::vec3 &pos, const glm::vec3 &color, float radius) {
-    if (_nextLightPos == std::size(_nextCompUboData.lights)) {
+    CompUboData &ubo = _gameSnapshot.compUboData;
+    if (_gameSnapshot.lightCount == std::size(ubo.lights)) {
         auto l = SLog::get();
         l->error("add light info exceed maximum capacity, skipping");
         return;
     }
-    _nextCompUboData.lights[_nextLightPos].position = glm::vec4{pos, 1};
-    _nextCompUboData.lights[_nextLightPos].colorAndRadius = glm::vec4{color, radius};
-    _nextLightPos++;
+    ubo.lights[_gameSnapshot.lightCount].position = glm::vec4{pos, 1};
+    ubo.lights[_gameSnapshot.lightCount].colorAndRadius = glm::vec4{color, radius};
+    _gameSnapshot.lightCount++;
 }
 
 bool Renderer::initImGUI() {
@@ -961,7 +1528,7 @@ bool Renderer::initImGUI() {
     // 2: initialize imgui library
     // initializes the core structures of imgui + SDL
     ImGui::CreateContext();
-    ImGui_ImplSDL3_InitForVulkan(_window);
+    if (!_renderConf.headless) ImGui_ImplSDL3_InitForVulkan(_window);
 
     // initializes imgui for Vulkan
     ImGui_ImplVulkan_InitInfo initInfo = {};
@@ -970,8 +1537,8 @@ bool Renderer::initImGUI() {
     initInfo.Device = _device;
     initInfo.Queue = _graphicsQueue;
     initInfo.DescriptorPool = imguiPool;
-    initInfo.MinImageCount = _swapchainImageViews.size();
-    initInfo.ImageCount = _swapchainImageViews.size();
+    initInfo.MinImageCount = std::max<uint32_t>(2, _swapchainImageViews.size());
+    initInfo.ImageCount = std::max<uint32_t>(2, _swapchainImageViews.size());
     initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     // initInfo.RenderPass = _compositionRenderPass;
     initInfo.UseDynamicRendering = true;
@@ -996,16 +1563,241 @@ bool Renderer::initImGUI() {
     return true;
 }
 
-void Renderer::newFrame() {
-    auto l = SLog::get();
+void Renderer::newFrame(float deltaTime) {
     ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplSDL3_NewFrame();
+    if (_renderConf.headless) {
+        ImGui::GetIO().DisplaySize = ImVec2(static_cast<float>(_swapChainExtent.width),
+                                            static_cast<float>(_swapChainExtent.height));
+    } else {
+        ImGui_ImplSDL3_NewFrame();
+    }
+    // use the paced delta instead of the one sampled by the sdl backend
+    if (deltaTime > 0) ImGui::GetIO().DeltaTime = deltaTime;
     ImGui::NewFrame();
+    ImGui::Text("World coord: up +y, right +x, forward -z");
+}
+
+void Renderer::writeDebugUi(const std::string &msg) { _debugUiText.emplace_back(msg); }
+
+void Renderer::submitFrame() {
+    // debug ui text buffer
+    for (const auto &t : _debugUiText) {
+        ImGui::Text("%s", t.c_str());
+    }
+    _debugUiText.clear();
+
+    // ui is finished on game thread, render thread only replays the cloned draw lists
+    ImGui::Render();
+    ImDrawData *drawData = ImGui::GetDrawData();
+    std::vector<ImDrawList *> uiDrawLists;
+    uiDrawLists.reserve(drawData->CmdListsCount);
+    for (int i = 0; i < drawData->CmdListsCount; ++i) {
+        uiDrawLists.push_back(drawData->CmdLists[i]->CloneOutput());
+    }
+
+    _gameSnapshot.uiDisplayPos = {drawData->DisplayPos.x, drawData->DisplayPos.y};
+    _gameSnapshot.uiDisplaySize = {drawData->DisplaySize.x, drawData->DisplaySize.y};
+    _gameSnapshot.uiFramebufferScale = {drawData->FramebufferScale.x,
+                                        drawData->FramebufferScale.y};
+    releaseUnusedMeshes();
+    // group instances by mesh, every copy of a mesh is drawn by one instanced draw per partition
+    // count per mesh first so transforms land contiguous without sorting
+    std::vector<RenderBatch> &batches = _gameSnapshot.batches;
+    batches.clear();
+    _batchLookup.clear();
+    uint32_t instanceCount = 0;
+    for (const auto &modalState : _modalStateList) {
+        if (_cullStamp != 0 && modalState->visibleStamp != _cullStamp) continue;
+        auto [iter, inserted] = _batchLookup.try_emplace(modalState->mesh.get(), batches.size());
+        if (inserted) batches.push_back({modalState->mesh.get(), 0, 0});
+        batches[iter->second].instanceCount++;
+        instanceCount++;
+    }
+    uint32_t firstInstance = 0;
+    for (RenderBatch &batch : batches) {
+        batch.firstInstance = firstInstance;
+        firstInstance += batch.instanceCount;
+        batch.instanceCount = 0;  // refilled below as the write cursor
+    }
+    _gameSnapshot.instanceTransforms.resize(instanceCount);
+    for (const auto &modalState : _modalStateList) {
+        if (_cullStamp != 0 && modalState->visibleStamp != _cullStamp) continue;
+        RenderBatch &batch = batches[_batchLookup[modalState->mesh.get()]];
+        _gameSnapshot.instanceTransforms[batch.firstInstance + batch.instanceCount++] =
+            modalState->worldTransform;
+    }
+    // lights are resubmitted every frame, don't leak removed lights into this one
+    CompUboData &ubo = _gameSnapshot.compUboData;
+    for (int i = _gameSnapshot.lightCount; i < std::size(ubo.lights); ++i) {
+        ubo.lights[i] = {};
+    }
+
+    {
+        // keep at most one frame queued, wait here if render thread hasn't picked it up yet
+        std::unique_lock lock(_handoffMutex);
+        _handoffCv.wait(lock, [this]() { return !_snapshotPending || _renderThreadStop; });
+        _pendingSnapshot = _gameSnapshot;
+        _pendingSnapshot.uiDrawLists = std::move(uiDrawLists);
+        _snapshotPending = true;
+    }
+    _handoffCv.notify_all();
+    _gameSnapshot.lightCount = 0;
+}
+
+void Renderer::runOnRenderThread(const std::function<void()> &function) {
+    // before render thread starts (initialisation) it's safe to call directly
+    if (!_renderThreadRunning) {
+        if (!_isShutdown) function();
+        return;
+    }
+    std::promise<void> done;
+    std::future<void> doneFuture = done.get_future();
+    enqueueRenderCmd([&function, &done]() {
+        function();
+        done.set_value();
+    });
+    doneFuture.wait();
+}
+
+void Renderer::enqueueRenderCmd(std::function<void()> function) {
+    if (!_renderThreadRunning) {
+        if (!_isShutdown) function();
+        return;
+    }
+    {
+        std::lock_guard lock(_handoffMutex);
+        _renderCmdQueue.push_back(std::move(function));
+    }
+    _handoffCv.notify_all();
+}
 
-    // command buffer
+void Renderer::renderThreadMain() {
+    Profiler::get()->setThreadName("Render");
+    std::deque<std::function<void()>> cmdList;
+    while (true) {
+        bool hasFrame = false;
+        bool stop = false;
+        {
+            std::unique_lock lock(_handoffMutex);
+            _handoffCv.wait(lock, [this]() {
+                return _renderThreadStop || _snapshotPending || !_renderCmdQueue.empty();
+            });
+            cmdList.swap(_renderCmdQueue);
+            if (_snapshotPending) {
+                std::swap(_renderSnapshot, _pendingSnapshot);
+                _snapshotPending = false;
+                hasFrame = true;
+            }
+            stop = _renderThreadStop;
+        }
+        _handoffCv.notify_all();
+
+        // uploads and deletes requested by game thread, in order
+        for (const auto &cmd : cmdList) {
+            cmd();
+        }
+        cmdList.clear();
+        retireGeometryBuffers();
+        // copies start now instead of waiting for the next frame
+        _uploads.flush();
+
+        if (stop) break;
+        if (hasFrame) renderFrame();
+    }
+}
+
+void Renderer::renderFrame() {
+    PROFILE_SCOPE("renderFrame");
+    // Wait for previous use of this flight slot to finish before touching its command buffers
+    {
+        PROFILE_SCOPE("waitFence");
+        vkWaitForFences(_device, 1, &_flightResources[_curFrameInFlight]->renderFence, VK_TRUE,
+                        UINT64_MAX);
+    }
+    collectGpuTimestamps();
+    _uploads.collect();
     vkResetCommandBuffer(_flightResources[_curFrameInFlight]->compCmdBuffer, 0);
     vkResetCommandBuffer(_flightResources[_curFrameInFlight]->mrtCmdBuffer, 0);
 
+    {
+        PROFILE_SCOPE("acquireImage");
+        acquireNextImage();
+    }
+    {
+        PROFILE_SCOPE("recordCmd");
+        _frameStats.drawCalls = 0;
+        _frameStats.triangles = 0;
+        _frameStats.candidateTriangles = 0;
+        beginRecordCmd();
+        drawAllModel();
+        endRecordCmd();
+    }
+    {
+        PROFILE_SCOPE("submitPresent");
+        draw();
+    }
+
+    // memory budget, vma keeps this cached so it's cheap to poll every frame
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(_allocator, budgets);
+    const VkPhysicalDeviceMemoryProperties *memProps{};
+    vmaGetMemoryProperties(_allocator, &memProps);
+    _frameStats.heapCount = memProps->memoryHeapCount;
+    for (uint32_t i = 0; i < memProps->memoryHeapCount; ++i) {
+        _frameStats.heapUsage[i] = budgets[i].usage;
+        _frameStats.heapBudget[i] = budgets[i].budget;
+    }
+    _frameStats.stagingUsed = _uploads.getRingUsed();
+    _frameStats.stagingSize = _uploads.getRingSize();
+    _frameStats.stagingStalls = _uploads.getRingStalls();
+    _frameStats.geometryUsed =
+        static_cast<uint64_t>(_vertexArena.getUsed()) * _vertexArena.getStride() +
+        static_cast<uint64_t>(_indexArena.getUsed()) * _indexArena.getStride();
+    _frameStats.geometrySize =
+        static_cast<uint64_t>(_vertexArena.getCapacity()) * _vertexArena.getStride() +
+        static_cast<uint64_t>(_indexArena.getCapacity()) * _indexArena.getStride();
+    {
+        std::lock_guard lock(_statsMutex);
+        _publishedStats = _frameStats;
+    }
+
+    releaseUiDrawLists(_renderSnapshot);
+    _renderFrameCount++;
+    flushDeferredDelete(false);
+    retireGeometryBuffers();
+}
+
+void Renderer::collectGpuTimestamps() {
+    FlightResource *flight = _flightResources[_curFrameInFlight];
+    if (!_timestampSupported || !flight->timestampWritten) return;
+
+    // fence already waited, results are available without blocking
+    uint64_t ticks[GPU_TIMESTAMP_COUNT];
+    if (vkGetQueryPoolResults(_device, flight->timestampPool, 0, GPU_TIMESTAMP_COUNT,
+                              sizeof(ticks), ticks, sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return;
+    }
+    auto toNs = [this, &ticks](int idx) {
+        return static_cast<int64_t>(static_cast<double>(ticks[idx] - ticks[0]) *
+                                    _timestampPeriodNs);
+    };
+    _frameStats.gpuMrtMs = static_cast<float>(toNs(1)) / 1e6f;
+    _frameStats.gpuCompMs = static_cast<float>(toNs(3) - toNs(2)) / 1e6f;
+
+    // gpu clock isn't calibrated against cpu, anchor the frame at its submit time
+    Profiler::get()->recordGpu("mrtPass", flight->submitCpuNs, flight->submitCpuNs + toNs(1));
+    Profiler::get()->recordGpu("compPass", flight->submitCpuNs + toNs(2),
+                               flight->submitCpuNs + toNs(3));
+}
+
+void Renderer::acquireNextImage() {
+    auto l = SLog::get();
+    // offscreen target is tied to the flight slot, nothing to acquire
+    if (_renderConf.headless) {
+        _curPresentImgIdx = _curFrameInFlight;
+        return;
+    }
     VkResult result = vkAcquireNextImageKHR(_device, _swapchain, UINT64_MAX,
                                             _flightResources[_curFrameInFlight]->imageAvailableSem,
                                             VK_NULL_HANDLE, &_curPresentImgIdx);
@@ -1028,6 +1820,17 @@ void Renderer::beginRecordCmd() {
         l->error("failed to begin recording command buffer!");
     }
 
+    // mrt is submitted first, so reset every query of this flight there
+    if (_timestampSupported) {
+        VkQueryPool pool = _flightResources[_curFrameInFlight]->timestampPool;
+        vkCmdResetQueryPool(_flightResources[_curFrameInFlight]->mrtCmdBuffer, pool, 0,
+                            GPU_TIMESTAMP_COUNT);
+        vkCmdWriteTimestamp(_flightResources[_curFrameInFlight]->mrtCmdBuffer,
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, 0);
+        vkCmdWriteTimestamp(_flightResources[_curFrameInFlight]->compCmdBuffer,
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, 2);
+    }
+
     // transition image layout at the start of the stage
     // TODO: we're hardcoding depth position to be 0
     VkImageMemoryBarrier barrier{};
@@ -1065,6 +1868,14 @@ void Renderer::beginRecordCmd() {
         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, barriers.size(),
         barriers.data());
 
+    // offscreen composition target has no presentation engine doing the transition for us
+    if (_renderConf.headless) {
+        auto transFn = transitionImgLayout(_swapchainImages[_curPresentImgIdx],
+                                           VK_IMAGE_LAYOUT_UNDEFINED,
+                                           VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        transFn(_flightResources[_curFrameInFlight]->compCmdBuffer);
+    }
+
     // create render info
     VkRenderingInfo mrtRenderInfo = {};
     mrtRenderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
@@ -1108,10 +1919,15 @@ void Renderer::beginRecordCmd() {
     compRenderInfo.colorAttachmentCount = 1;
     compRenderInfo.pColorAttachments = &compAttachmentInfo;
 
+    // compute can't run inside dynamic rendering, cull before the pass starts
+    writeFrameInstances();
+    if (_gpuDriven) recordCullPass();
+
     // start render pass
     vkCmdBeginRendering(_flightResources[_curFrameInFlight]->mrtCmdBuffer, &mrtRenderInfo);
     vkCmdBindPipeline(_flightResources[_curFrameInFlight]->mrtCmdBuffer,
-                      VK_PIPELINE_BIND_POINT_GRAPHICS, _mrtPipeline);
+                      VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      _gpuDriven ? _mrtIndirectPipeline : _mrtPipeline);
     vkCmdBeginRendering(_flightResources[_curFrameInFlight]->compCmdBuffer, &compRenderInfo);
     vkCmdBindPipeline(_flightResources[_curFrameInFlight]->compCmdBuffer,
                       VK_PIPELINE_BIND_POINT_GRAPHICS, _compPipeline);
@@ -1121,58 +1937,193 @@ void Renderer::beginRecordCmd() {
         _flightResources[_curFrameInFlight]->compCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
         _compPipelineLayout, 0, _flightResources[_curFrameInFlight]->compDescSetList.size(),
         _flightResources[_curFrameInFlight]->compDescSetList.data(), 0, nullptr);
+}
 
-    // Draw imgui
-    ImGui::Text("World coord: up +y, right +x, forward -z");
+void Renderer::writeFrameInstances() {
+    FlightResource *flight = _flightResources[_curFrameInFlight];
+    const std::vector<RenderBatch> &batches = _renderSnapshot.batches;
+    auto instanceCount = static_cast<uint32_t>(_renderSnapshot.instanceTransforms.size());
+    uint32_t drawCount = 0;
+    for (const RenderBatch &batch : batches) {
+        drawCount += batch.mesh->modelDataPartition.size();
+    }
+    _indirectDrawCount = 0;
+    if (!reserveFrameBuffers(*flight, instanceCount, batches.size(), drawCount)) {
+        // skip the frame's geometry rather than write past the buffers
+        _renderSnapshot.batches.clear();
+        return;
+    }
+    _frameStats.instances = instanceCount;
+    _frameStats.batches = batches.size();
+
+    auto *instances = static_cast<GpuInstanceData *>(flight->instanceBuffer.allocInfo.pMappedData);
+    for (uint32_t batchIdx = 0; batchIdx < batches.size(); ++batchIdx) {
+        const RenderBatch &batch = batches[batchIdx];
+        for (uint32_t i = batch.firstInstance; i < batch.firstInstance + batch.instanceCount; ++i) {
+            instances[i].worldTransform = _renderSnapshot.instanceTransforms[i];
+            instances[i].batchIdx = batchIdx;
+        }
+    }
+    if (!_gpuDriven) return;
+
+    // batch bounds for the instance cull, one draw per batch partition for the emit pass
+    auto *gpuBatches = static_cast<GpuBatchData *>(flight->batchBuffer.allocInfo.pMappedData);
+    auto *draws = static_cast<GpuDrawData *>(flight->drawBuffer.allocInfo.pMappedData);
+    for (uint32_t batchIdx = 0; batchIdx < batches.size(); ++batchIdx) {
+        const RenderBatch &batch = batches[batchIdx];
+        const MeshGpu *mesh = batch.mesh;
+        gpuBatches[batchIdx] = {glm::vec4{mesh->boundsMin, 1}, glm::vec4{mesh->boundsMax, 1},
+                                batch.firstInstance, batch.instanceCount, {}};
+        if (mesh->vertexRange == GEOMETRY_NULL_RANGE || mesh->indexRange == GEOMETRY_NULL_RANGE) {
+            continue;
+        }
+        auto vertexOffset = static_cast<int32_t>(_vertexArena.getOffset(mesh->vertexRange));
+        uint32_t indexOffset = _indexArena.getOffset(mesh->indexRange);
+        for (const auto &modalDataPart : mesh->modelDataPartition) {
+            auto mat = _materialMap.find(modalDataPart.materialId);
+            if (mat == _materialMap.end() || mat->second->materialSlot == UINT32_MAX) continue;
+            draws[_indirectDrawCount++] = {
+                batchIdx, mat->second->materialSlot,
+                indexOffset + static_cast<uint32_t>(modalDataPart.firstIndex),
+                static_cast<uint32_t>(modalDataPart.indexCount), vertexOffset};
+            // culling result stays on gpu, only the upper bound is known here
+            _frameStats.candidateTriangles +=
+                static_cast<uint64_t>(modalDataPart.indexCount / 3) * batch.instanceCount;
+        }
+    }
 }
 
 void Renderer::drawAllModel() {
+    FlightResource *flight = _flightResources[_curFrameInFlight];
+    VkCommandBuffer cmd = flight->mrtCmdBuffer;
+
+    // all geometry lives in the two arenas, bind them once for the whole pass
+    VkDeviceSize offsets[] = {0};
+    VkBuffer vertexBuffer = _vertexArena.getBuffer();
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, offsets);
+    vkCmdBindIndexBuffer(cmd, _indexArena.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+    if (_gpuDriven) {
+        drawAllModelIndirect();
+        return;
+    }
+    if (_renderSnapshot.batches.empty()) return;
+
+    // instance transforms are vertex input, camera is shared by every draw
+    vkCmdBindVertexBuffers(cmd, 1, 1, &flight->instanceBuffer.buffer, offsets);
     MrtPushConstantData mrtData{};
+    mrtData.viewTransform = _renderSnapshot.camViewTransform;
+    mrtData.perspectiveTransform = _renderSnapshot.camProjectionTransform;
+    vkCmdPushConstants(cmd, _mrtPipelineLayout,
+                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                       sizeof(MrtPushConstantData), &mrtData);
 
-    for (const auto &modalState : _modalStateList) {
-        // compute final transform
-        mrtData.viewModalTransform = _camViewTransform * modalState->worldTransform;
-        mrtData.perspectiveTransform = _camProjectionTransform;
-        vkCmdPushConstants(_flightResources[_curFrameInFlight]->mrtCmdBuffer, _mrtPipelineLayout,
-                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
-                           sizeof(MrtPushConstantData), &mrtData);
-
-        // bind group of vertex and indices
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(_flightResources[_curFrameInFlight]->mrtCmdBuffer, 0, 1,
-                               &modalState->vBuffer, offsets);
-        vkCmdBindIndexBuffer(_flightResources[_curFrameInFlight]->mrtCmdBuffer, modalState->iBuffer,
-                             0, VK_INDEX_TYPE_UINT32);
-
-        // modal partition based on material
-        for (const auto &modalDataPart : modalState->modelDataPartition) {
+    for (const RenderBatch &batch : _renderSnapshot.batches) {
+        const MeshGpu *mesh = batch.mesh;
+        if (mesh->vertexRange == GEOMETRY_NULL_RANGE || mesh->indexRange == GEOMETRY_NULL_RANGE) {
+            continue;
+        }
+        auto vertexOffset = static_cast<int32_t>(_vertexArena.getOffset(mesh->vertexRange));
+        uint32_t indexOffset = _indexArena.getOffset(mesh->indexRange);
+
+        // modal partition based on material, every copy of the mesh in one instanced draw
+        for (const auto &modalDataPart : mesh->modelDataPartition) {
             auto mat = _materialMap[modalDataPart.materialId];
             // bind resources
-            vkCmdBindDescriptorSets(_flightResources[_curFrameInFlight]->mrtCmdBuffer,
-                                    VK_PIPELINE_BIND_POINT_GRAPHICS, _mrtPipelineLayout, 0, 1,
-                                    &mat->descriptorSet, 0, nullptr);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, _mrtPipelineLayout, 0,
+                                    1, &mat->descriptorSet, 0, nullptr);
             // uniform data
             memcpy(mat->uniformAllocInfo.pMappedData, &mat->uboData, sizeof(MrtUboData));
             // draw index partition
-            vkCmdDrawIndexed(_flightResources[_curFrameInFlight]->mrtCmdBuffer,
-                             modalDataPart.indexCount, 1, modalDataPart.firstIndex, 0, 0);
+            vkCmdDrawIndexed(cmd, modalDataPart.indexCount, batch.instanceCount,
+                             indexOffset + modalDataPart.firstIndex, vertexOffset,
+                             batch.firstInstance);
+            _frameStats.drawCalls++;
+            _frameStats.triangles +=
+                static_cast<uint64_t>(modalDataPart.indexCount / 3) * batch.instanceCount;
         }
     }
 }
 
-void Renderer::writeDebugUi(const std::string &msg) { _debugUiText.emplace_back(msg); }
+void Renderer::recordCullPass() {
+    FlightResource *flight = _flightResources[_curFrameInFlight];
+    VkCommandBuffer cmd = flight->mrtCmdBuffer;
+    if (_indirectDrawCount == 0) return;
+
+    // command count and per batch visible counts restart at zero, both passes append to them
+    auto batchCount = static_cast<uint32_t>(_renderSnapshot.batches.size());
+    vkCmdFillBuffer(cmd, flight->countBuffer.buffer, 0, sizeof(uint32_t) * (batchCount + 1), 0);
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0,
+                         nullptr);
+
+    CullPushConstantData cullData{};
+    Frustum frustum = Frustum::fromMatrix(_renderSnapshot.camProjectionTransform *
+                                          _renderSnapshot.camViewTransform);
+    std::copy(std::begin(frustum.planes), std::end(frustum.planes), cullData.frustumPlanes);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipelineLayout, 0, 1,
+                            &flight->cullDescSet, 0, nullptr);
+
+    // pass 0, cull every instance into its batch range
+    cullData.itemCount = static_cast<uint32_t>(_renderSnapshot.instanceTransforms.size());
+    cullData.pass = 0;
+    vkCmdPushConstants(cmd, _cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(CullPushConstantData), &cullData);
+    vkCmdDispatch(cmd, (cullData.itemCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0,
+                         nullptr);
+
+    // pass 1, one instanced command per partition of a batch with anything visible
+    cullData.itemCount = _indirectDrawCount;
+    cullData.pass = 1;
+    vkCmdPushConstants(cmd, _cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(CullPushConstantData), &cullData);
+    vkCmdDispatch(cmd, (cullData.itemCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // commands and count feed the indirect draw, visible lists are read by the vertex shader
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
 
-void Renderer::endRecordCmd() {
-    // debug ui text buffer
-    for (const auto &t : _debugUiText) {
-        ImGui::Text("%s", t.c_str());
-    }
-    _debugUiText.clear();
+void Renderer::drawAllModelIndirect() {
+    FlightResource *flight = _flightResources[_curFrameInFlight];
+    VkCommandBuffer cmd = flight->mrtCmdBuffer;
+    _frameStats.gpuDriven = true;
+    _frameStats.drawCandidates = _indirectDrawCount;
+    if (_indirectDrawCount == 0) return;
 
+    std::array<VkDescriptorSet, 2> sets = {flight->cullDescSet, _bindlessSet};
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, _mrtIndirectPipelineLayout, 0,
+                            sets.size(), sets.data(), 0, nullptr);
+    MrtPushConstantData mrtData{};
+    mrtData.viewTransform = _renderSnapshot.camViewTransform;
+    mrtData.perspectiveTransform = _renderSnapshot.camProjectionTransform;
+    vkCmdPushConstants(cmd, _mrtIndirectPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                       sizeof(MrtPushConstantData), &mrtData);
+
+    // one call whatever the object count, culled draws never reach the gpu front end
+    vkCmdDrawIndexedIndirectCount(
+        cmd, flight->commandBuffer.buffer, 0, flight->countBuffer.buffer, 0,
+        std::min(_indirectDrawCount, _gpuProperties.limits.maxDrawIndirectCount),
+        sizeof(VkDrawIndexedIndirectCommand));
+    _frameStats.drawCalls++;
+}
+
+void Renderer::endRecordCmd() {
     // uniform data
-    memcpy(_flightResources[_curFrameInFlight]->compUniformAllocInfo.pMappedData, &_nextCompUboData,
-           sizeof(CompUboData));
-    _nextLightPos = 0;
+    memcpy(_flightResources[_curFrameInFlight]->compUniformAllocInfo.pMappedData,
+           &_renderSnapshot.compUboData, sizeof(CompUboData));
 
     // Push constant for composition
     CompPushConstantData pushConstantData{};
@@ -1184,23 +2135,47 @@ void Renderer::endRecordCmd() {
     // Issue draw a single triangle that covers full screen
     vkCmdDraw(_flightResources[_curFrameInFlight]->compCmdBuffer, 3, 1, 0, 0);
 
-    // IMGUI draw last call
-    ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(),
+    // IMGUI draw last call, replay draw lists built by game thread
+    ImDrawData uiDrawData{};
+    uiDrawData.Valid = true;
+    uiDrawData.DisplayPos = ImVec2(_renderSnapshot.uiDisplayPos.x, _renderSnapshot.uiDisplayPos.y);
+    uiDrawData.DisplaySize =
+        ImVec2(_renderSnapshot.uiDisplaySize.x, _renderSnapshot.uiDisplaySize.y);
+    uiDrawData.FramebufferScale =
+        ImVec2(_renderSnapshot.uiFramebufferScale.x, _renderSnapshot.uiFramebufferScale.y);
+    for (ImDrawList *drawList : _renderSnapshot.uiDrawLists) {
+        uiDrawData.CmdLists.push_back(drawList);
+        uiDrawData.TotalVtxCount += drawList->VtxBuffer.Size;
+        uiDrawData.TotalIdxCount += drawList->IdxBuffer.Size;
+    }
+    uiDrawData.CmdListsCount = uiDrawData.CmdLists.Size;
+    ImGui_ImplVulkan_RenderDrawData(&uiDrawData,
                                     _flightResources[_curFrameInFlight]->compCmdBuffer);
 
     // transition image layout for presentation
     auto l = SLog::get();
     vkCmdEndRendering(_flightResources[_curFrameInFlight]->mrtCmdBuffer);
+    if (_timestampSupported) {
+        vkCmdWriteTimestamp(_flightResources[_curFrameInFlight]->mrtCmdBuffer,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            _flightResources[_curFrameInFlight]->timestampPool, 1);
+    }
     if (vkEndCommandBuffer(_flightResources[_curFrameInFlight]->mrtCmdBuffer) != VK_SUCCESS) {
         l->error("failed to end record command buffer!");
     }
 
     vkCmdEndRendering(_flightResources[_curFrameInFlight]->compCmdBuffer);
-    auto transFn = transitionImgLayout(_swapchainImages[_curFrameInFlight],
-                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
-    transFn(_flightResources[_curFrameInFlight]->compCmdBuffer);
+    if (!_renderConf.headless) {
+        auto transFn = transitionImgLayout(_swapchainImages[_curPresentImgIdx],
+                                           VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                           VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        transFn(_flightResources[_curFrameInFlight]->compCmdBuffer);
+    }
+    if (_timestampSupported) {
+        vkCmdWriteTimestamp(_flightResources[_curFrameInFlight]->compCmdBuffer,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            _flightResources[_curFrameInFlight]->timestampPool, 3);
+    }
     if (vkEndCommandBuffer(_flightResources[_curFrameInFlight]->compCmdBuffer) != VK_SUCCESS) {
         l->error("failed to end record command buffer!");
     }
@@ -1208,14 +2183,16 @@ void Renderer::endRecordCmd() {
 
 void Renderer::draw() {
     auto l = SLog::get();
-    // Wait for previous frame to finish (takes array of fences)
-    vkWaitForFences(_device, 1, &_flightResources[_curFrameInFlight]->renderFence, VK_TRUE,
-                    UINT64_MAX);
-    // reset to unsignaled only if we're sure we have work to do.
+    // fence is waited in renderFrame, reset to unsignaled only if we're sure we have work to do.
     vkResetFences(_device, 1, &_flightResources[_curFrameInFlight]->renderFence);
-
-    // sync primitive
-    VkSemaphore mrtWaitSem[] = {_flightResources[_curFrameInFlight]->imageAvailableSem};
+    _flightResources[_curFrameInFlight]->submitCpuNs = Profiler::get()->nowNs();
+    _flightResources[_curFrameInFlight]->timestampWritten = _timestampSupported;
+
+    // sync primitive, upload timeline first so headless can drop the image wait
+    VkSemaphore mrtWaitSem[] = {_uploads.getTimeline(),
+                                _flightResources[_curFrameInFlight]->imageAvailableSem};
+    // anything recorded since the last flush (arena compaction) is submitted here
+    uint64_t mrtWaitValues[] = {_uploads.flush(), 0};  // binary semaphore value ignored
     VkSemaphore mrtSignalSem[] = {_flightResources[_curFrameInFlight]->mrtSemaphore};
     VkSemaphore compSignalSem[] = {_flightResources[_curFrameInFlight]->compSemaphore};
 
@@ -1225,9 +2202,20 @@ void Renderer::draw() {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &_flightResources[_curFrameInFlight]->mrtCmdBuffer;
 
+    // geometry and textures uploaded so far must land before vertex fetch / sampling
     // wait at the writing color before the image is available
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = std::size(mrtWaitSem);
+    // headless never acquires an image, so there is nothing to wait on
+    VkPipelineStageFlags waitStages[] = {
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    uint32_t mrtWaitCount = _renderConf.headless ? 1 : std::size(mrtWaitSem);
+    VkTimelineSemaphoreSubmitInfo mrtTimelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = mrtWaitCount,
+        .pWaitSemaphoreValues = mrtWaitValues,
+    };
+    submitInfo.pNext = &mrtTimelineInfo;
+    submitInfo.waitSemaphoreCount = mrtWaitCount;
     submitInfo.pWaitSemaphores = mrtWaitSem;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.signalSemaphoreCount = std::size(mrtSignalSem);
@@ -1236,14 +2224,22 @@ void Renderer::draw() {
     l->vk_res(vkQueueSubmit(_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE));
 
     // Submit Composition ---------------------------------------------------
+    VkPipelineStageFlags compWaitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    submitInfo.pNext = nullptr;
     submitInfo.pCommandBuffers = &_flightResources[_curFrameInFlight]->compCmdBuffer;
     submitInfo.waitSemaphoreCount = std::size(mrtSignalSem);
     submitInfo.pWaitSemaphores = mrtSignalSem;
-    submitInfo.signalSemaphoreCount = std::size(compSignalSem);
+    submitInfo.pWaitDstStageMask = compWaitStages;
+    submitInfo.signalSemaphoreCount = _renderConf.headless ? 0 : std::size(compSignalSem);
     submitInfo.pSignalSemaphores = compSignalSem;
     l->vk_res(vkQueueSubmit(_graphicsQueue, 1, &submitInfo,
                             _flightResources[_curFrameInFlight]->renderFence));
 
+    if (_renderConf.headless) {
+        _curFrameInFlight = (_curFrameInFlight + 1) % _renderConf.maxFrameInFlight;
+        return;
+    }
+
     // Submit result back to swap chain
     // What to signal when we're done
     VkPresentInfoKHR presentInfo{};
@@ -1262,88 +2258,6 @@ void Renderer::draw() {
     _curFrameInFlight = (_curFrameInFlight + 1) % _renderConf.maxFrameInFlight;
 }
 
-void Renderer::execOneTimeCmd(const std::function<void(VkCommandBuffer)> &function) {
-    auto l = SLog::get();
-    // One time sync fence
-    VkFenceCreateInfo fenceInfo = CreationHelper::createFenceInfo(false);
-    VkFence oneTimeFence;
-    l->vk_res(vkCreateFence(_device, &fenceInfo, nullptr, &oneTimeFence));
-
-    // Create new command buffer
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = _oneTimeCmdPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    if (vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate command buffers!");
-    }
-
-    // Immediately record command buffer (one time)
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
-        throw std::runtime_error("failed to begin recording command buffer!");
-    }
-
-    // execute the function
-    function(commandBuffer);
-
-    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
-        throw std::runtime_error("failed to record command buffer!");
-    }
-
-    // Execute command buffer to transfer
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    if (vkQueueSubmit(_graphicsQueue, 1, &submitInfo, oneTimeFence) != VK_SUCCESS) {
-        throw std::runtime_error("failed to submit command buffer!");
-    }
-
-    // Wait operation to complete
-    vkWaitForFences(_device, 1, &oneTimeFence, true, 1000000000);
-
-    // Free one time resources
-    vkFreeCommandBuffers(_device, _oneTimeCmdPool, 1, &commandBuffer);
-    vkDestroyFence(_device, oneTimeFence, nullptr);
-}
-
-void Renderer::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-    auto func = [=](VkCommandBuffer cmdBuf) {
-        VkBufferCopy copyRegion{};
-        copyRegion.size = size;
-        vkCmdCopyBuffer(cmdBuf, srcBuffer, dstBuffer, 1, &copyRegion);
-    };
-    execOneTimeCmd(func);
-}
-
-void Renderer::copyBufferToImg(VkBuffer srcBuffer, VkImage dstImg, VkExtent2D extent) {
-    auto func = [=](VkCommandBuffer cmdBuf) {
-        VkBufferImageCopy copyRegion{};
-        copyRegion.bufferOffset = 0;
-        copyRegion.bufferRowLength = 0;
-        copyRegion.bufferImageHeight = 0;
-
-        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.mipLevel = 0;
-        copyRegion.imageSubresource.baseArrayLayer = 0;
-        copyRegion.imageSubresource.layerCount = 1;
-
-        copyRegion.imageOffset = {0, 0, 0};
-        copyRegion.imageExtent = {extent.width, extent.height, 1};
-        vkCmdCopyBufferToImage(cmdBuf, srcBuffer, dstImg, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                               &copyRegion);
-    };
-    execOneTimeCmd(func);
-}
-
 std::function<void(VkCommandBuffer)> Renderer::transitionImgLayout(VkImage image,
                                                                    VkImageLayout oldLayout,
                                                                    VkImageLayout newLayout) {
@@ -1384,6 +2298,13 @@ std::function<void(VkCommandBuffer)> Renderer::transitionImgLayout(VkImage image
             barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             destStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
             barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        } else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED &&
+                   newLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+            // offscreen target, previous content is discarded
+            sourceStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            barrier.srcAccessMask = VK_ACCESS_NONE;
+            destStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
         } else if (oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL &&
                    newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
             // swapchain presentation
@@ -1406,28 +2327,12 @@ void Renderer::uploadImageForSampling(const TextureData &cpuTexData, ImgResource
     l->debug(fmt::format("upload texture dim: ({:d}, {:d}, {:d})", cpuTexData.texWidth,
                          cpuTexData.texHeight, cpuTexData.texChannels));
 
-    // Create buffer for transfer source image
-    VkBuffer texBuffer;
-    VmaAllocationCreateInfo stagingAllocInfo = CreationHelper::createStagingAllocInfo();
-    VmaAllocation stagingAllocation;
-    VmaAllocationInfo stagingAllocationInfo;
-
-    VkBufferCreateInfo texBufferCreateInfo{};
-    texBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    texBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    texBufferCreateInfo.size = cpuTexData.texWidth * cpuTexData.texHeight * cpuTexData.texChannels;
-    texBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    l->vk_res(vmaCreateBuffer(_allocator, &texBufferCreateInfo, &stagingAllocInfo, &texBuffer,
-                              &stagingAllocation, &stagingAllocationInfo));
-    memcpy(stagingAllocationInfo.pMappedData, cpuTexData.data, texBufferCreateInfo.size);
-    vmaFlushAllocation(_allocator, stagingAllocation, 0,
-                       texBufferCreateInfo.size);  // TODO: Transfer to destination buffer
-
     // Create GPU local sampled image
     VkExtent2D ext{static_cast<uint32_t>(cpuTexData.texWidth),
                    static_cast<uint32_t>(cpuTexData.texHeight)};
     VkImageCreateInfo textureImageInfo = CreationHelper::imageCreateInfo(
         sampleFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, ext);
+    _uploads.applySharing(textureImageInfo);
     // allocate from GPU LOCAL memory
     VmaAllocationCreateInfo texAllocInfo{};
     texAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -1436,21 +2341,10 @@ void Renderer::uploadImageForSampling(const TextureData &cpuTexData, ImgResource
                                      &outResourceInfo.image, &outResourceInfo.allocation, nullptr);
     l->vk_res(result);
 
-    // transition the layout image for layout destination
-    auto transFn = transitionImgLayout(outResourceInfo.image, VK_IMAGE_LAYOUT_UNDEFINED,
-                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    execOneTimeCmd(transFn);
-
-    // perform copy operation
-    copyBufferToImg(texBuffer, outResourceInfo.image, ext);
-
-    // make it optimal for sampling
-    transFn = transitionImgLayout(outResourceInfo.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    execOneTimeCmd(transFn);
-
-    // staging buffer can be destroyed as src textures are no longer used
-    vmaDestroyBuffer(_allocator, texBuffer, stagingAllocation);
+    // copy and layout transitions ride the open upload batch, frame waits for it on the gpu
+    VkDeviceSize size = static_cast<VkDeviceSize>(cpuTexData.texWidth) * cpuTexData.texHeight *
+                        cpuTexData.texChannels;
+    _uploads.uploadImage(cpuTexData.data, size, outResourceInfo.image, ext);
 
     // image view and sampler
     VkImageViewCreateInfo createImgViewInfo = CreationHelper::imageViewCreateInfo(
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "utils/common.hpp"
 #include "def.hpp"
+#include "upload_manager.hpp"
+#include "geometry_arena.hpp"
 
 // think about what kind of abstraction to expose to upper user
 // for vulkan renderer?
@@ -10,6 +17,16 @@ namespace luna {
 
 constexpr int MRT_SAMPLE_SIZE = 3;
 constexpr int MRT_OUT_SIZE = 4;
+// begin/end of mrt and composition pass
+constexpr int GPU_TIMESTAMP_COUNT = 4;
+// starting size of the shared geometry buffers, they grow by doubling
+constexpr uint32_t GEOMETRY_INITIAL_VERTICES = 1 << 18;
+constexpr uint32_t GEOMETRY_INITIAL_INDICES = 1 << 20;
+// gpu driven path, bindless table sizes and culling workgroup
+constexpr uint32_t MAX_BINDLESS_MATERIALS = 4096;
+constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
+constexpr uint32_t CULL_GROUP_SIZE = 64;  // local_size_x of cull.comp
+constexpr uint32_t FRAME_INITIAL_INSTANCES = 1024;  // per flight buffers grow by doubling
 
 // resources in a single flight
 struct FlightResource {
@@ -32,6 +49,26 @@ struct FlightResource {
 
         VkSemaphore imageAvailableSem{};
         VkFence renderFence{};
+
+        // Gpu pass timing
+        VkQueryPool timestampPool{};
+        bool timestampWritten = false;
+        int64_t submitCpuNs = 0;  // used to place gpu passes on the profiler timeline
+
+        // Per instance transforms, vertex input of the cpu path, culled by the gpu driven path
+        BufferResource instanceBuffer;
+        uint32_t instanceCapacity = 0;
+
+        // Gpu driven mrt, batch / draw lists written by cpu, the rest by the cull passes
+        VkDescriptorSet cullDescSet{};
+        BufferResource batchBuffer;
+        BufferResource drawBuffer;
+        BufferResource commandBuffer;
+        BufferResource countBuffer;  // command count, then visible instances per batch
+        BufferResource visibleDrawBuffer;  // draw index of each written command
+        BufferResource visibleInstanceBuffer;  // instance index, in batch ranges
+        uint32_t batchCapacity = 0;
+        uint32_t drawCapacity = 0;
 };
 
 class Renderer {
@@ -43,33 +80,58 @@ class Renderer {
         void shutdown();
         // void rebuild();
 
-        // render related, should invoke in order
-        void newFrame();
-        void beginRecordCmd();
-        void drawAllModel();
+        // game thread, build ui for the next frame then publish the snapshot to render thread
+        // publish blocks only when render thread is still one whole frame behind
+        void newFrame(float deltaTime);
         void writeDebugUi(const std::string &msg);
-        void endRecordCmd();
-        void draw();
+        void submitFrame();
 
-        // data related
-        int createMaterial(MaterialCpu &materialCpu);  // return material id
-        std::shared_ptr<ModalState> uploadModel(ModelDataCpu &modelData);
+        // data related, queued to render thread and copied on the transfer queue, caller never
+        // waits, the first frame that can draw the result waits for the copy on the gpu
+        int createMaterial(MaterialCpu &materialCpu);  // return material id, texture data copied
+        // upload geometry once, any number of modal instances can draw it, modelData is moved
+        std::shared_ptr<MeshGpu> uploadMesh(ModelDataCpu &modelData);
+        // new drawn instance of an uploaded mesh, no gpu work
+        // every instance of a mesh is drawn by the same instanced draw, reuse meshes for props
+        std::shared_ptr<ModalState> addModal(const std::shared_ptr<MeshGpu> &mesh);
+        // stop drawing the instance, the mesh goes once nothing on game thread references it
+        // gpu resources are released once no frame in flight can reference them
         void removeModal(const std::shared_ptr<ModalState> &modelData);
 
-        // setter
-        void setViewMatrix(const glm::mat4 &viewTransform) { _camViewTransform = viewTransform; };
+        // setter, write into the snapshot being built by game thread
+        void setViewMatrix(const glm::mat4 &viewTransform) {
+            _gameSnapshot.camViewTransform = viewTransform;
+        };
         void setProjectionMatrix(const glm::mat4 &projectionTransform) {
-            _camProjectionTransform = projectionTransform;
+            _gameSnapshot.camProjectionTransform = projectionTransform;
+        };
+        void setCamPos(const glm::vec3 &pos) {
+            _gameSnapshot.compUboData.camPos = glm::vec4{pos, 1};
         };
-        void setCamPos(const glm::vec3 &pos) { _nextCompUboData.camPos = glm::vec4{pos, 1}; };
         void setLightInfo(const glm::vec3 &pos, const glm::vec3 &color, float radius);
         void setDirLight(const glm::vec3 &dir, const glm::vec3 &color) {
-            _nextCompUboData.dirLight = {glm::vec4{dir, 1}, glm::vec4{color, 1}};
+            _gameSnapshot.compUboData.dirLight = {glm::vec4{dir, 1}, glm::vec4{color, 1}};
         };
         void setClearColor(const glm::vec3 &color) { _clearVal = {color.x, color.y, color.z, 1}; };
+        // only instances stamped with this value are drawn next frame, 0 draws everything
+        void setCullStamp(uint64_t stamp) { _cullStamp = stamp; }
 
         // getter
         [[nodiscard]] const RenderConfig &getRenderConfig() { return _renderConf; }
+        // fixed after init, instances are frustum culled by cull.comp instead of the game thread
+        [[nodiscard]] bool isGpuDriven() const { return _gpuDriven; }
+        [[nodiscard]] bool isHeadless() const { return _renderConf.headless; }
+        [[nodiscard]] glm::vec3 getClearColor() const {
+            return {_clearVal.color.float32[0], _clearVal.color.float32[1],
+                    _clearVal.color.float32[2]};
+        }
+        [[nodiscard]] const DirectionalLight &getDirLight() const {
+            return _gameSnapshot.compUboData.dirLight;
+        }
+        [[nodiscard]] RenderStats getRenderStats() {
+            std::lock_guard lock(_statsMutex);
+            return _publishedStats;
+        }
 
     private:
         // internal creations
@@ -86,27 +148,80 @@ class Renderer {
         bool initImGUI();
         bool initPreApp();
 
+        // render thread
+        void renderThreadMain();
+        void renderFrame();
+        void acquireNextImage();
+        void beginRecordCmd();
+        void drawAllModel();
+        // instance transforms, plus batch / draw lists for the gpu driven path
+        void writeFrameInstances();
+        bool reserveFrameBuffers(FlightResource &flight, uint32_t instanceCount,
+                                 uint32_t batchCount, uint32_t drawCount);
+        // gpu driven path, cull the lists into indirect commands
+        void recordCullPass();
+        void drawAllModelIndirect();
+        void writeBindlessMaterial(MaterialGpu &material);
+        void releaseBindlessMaterial(const MaterialGpu &material);
+        void endRecordCmd();
+        void draw();
+        void runOnRenderThread(const std::function<void()> &function);
+        void enqueueRenderCmd(std::function<void()> function);
+        void flushDeferredDelete(bool force);
+        void collectGpuTimestamps();
+        void createMaterialInternal(const MaterialCpu &materialCpu, int matId);
+        void uploadMeshInternal(MeshGpu &mesh, const ModelDataCpu &modelData);
+        void destroyMeshInternal(const std::shared_ptr<MeshGpu> &mesh);
+        // buffers replaced by arena growth / compaction go through deferred delete
+        void retireGeometryBuffers();
+        void releaseUnusedMeshes();
+
         // Command Helper
-        void execOneTimeCmd(const std::function<void(VkCommandBuffer)> &function);
-        void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-        void copyBufferToImg(VkBuffer srcBuffer, VkImage dstImg, VkExtent2D extent);
         std::function<void(VkCommandBuffer)> transitionImgLayout(VkImage image,
                                                                  VkImageLayout oldLayout,
                                                                  VkImageLayout newLayout);
         void uploadImageForSampling(const TextureData &cpuTexData, ImgResource &outResourceInfo,
                                     VkFormat sampleFormat);
 
-        // Current draw state
+        // Current draw state, owned by render thread
         int _curFrameInFlight = 0;
         uint32_t _curPresentImgIdx = 0;
-        glm::mat4 _camViewTransform{};
-        glm::mat4 _camProjectionTransform{};
-        CompUboData _nextCompUboData{};
-        int _nextLightPos{};
-        std::vector<std::string> _debugUiText;
-        int _nextMatId = 0;
         std::unordered_map<int, std::shared_ptr<MaterialGpu>> _materialMap;
+        RenderSnapshot _renderSnapshot;
+        uint64_t _renderFrameCount = 0;
+        std::vector<std::pair<uint64_t, std::function<void()>>> _deferredDelete;
+        bool _timestampSupported = false;
+        float _timestampPeriodNs = 1;
+        uint32_t _indirectDrawCount = 0;  // batch partitions written this frame
+        std::vector<uint32_t> _freeMaterialSlots;
+        std::vector<uint32_t> _freeTextureSlots;
+        uint32_t _nextMaterialSlot = 0;
+        uint32_t _nextTextureSlot = 0;
+        RenderStats _frameStats;  // being collected for current frame
+
+        // stats readable by game thread
+        std::mutex _statsMutex;
+        RenderStats _publishedStats;
+
+        // Game thread state
+        RenderSnapshot _gameSnapshot;
         std::vector<std::shared_ptr<ModalState>> _modalStateList;
+        uint64_t _cullStamp = 0;
+        std::vector<std::shared_ptr<MeshGpu>> _meshList;
+        std::unordered_map<const MeshGpu *, uint32_t> _batchLookup;  // reused by submitFrame
+        int _nextMatId = 0;
+        std::vector<std::string> _debugUiText;
+
+        // Game -> render thread handoff, guarded by _handoffMutex
+        std::thread _renderThread;
+        std::mutex _handoffMutex;
+        std::condition_variable _handoffCv;
+        RenderSnapshot _pendingSnapshot;
+        bool _snapshotPending = false;
+        std::deque<std::function<void()>> _renderCmdQueue;
+        bool _renderThreadRunning = false;
+        bool _renderThreadStop = false;
+        bool _isShutdown = false;
 
         // user settable basic config?
         VkClearValue _clearVal = {.color = {0, 0, 0}};
@@ -130,6 +245,7 @@ class Renderer {
 
         // props
         VkPhysicalDeviceFeatures _requiredPhysicalDeviceFeatures{};
+        bool _gpuDriven = false;  // requested and supported by the device
         VkFormat _depthFormat{};
 
         // Queues
@@ -137,6 +253,11 @@ class Renderer {
         uint32_t _graphicsQueueFamily{};
         VkQueue _presentsQueue{};
         uint32_t _presentsQueueFamily{};
+        VkQueue _transferQueue{};
+        uint32_t _transferQueueFamily{};
+        UploadManager _uploads;  // render thread
+        GeometryArena _vertexArena;
+        GeometryArena _indexArena;
 
         // Swapchain & Renderpass & framebuffer
         VkSwapchainKHR _swapchain{};
@@ -144,6 +265,7 @@ class Renderer {
         VkExtent2D _swapChainExtent{};
         std::vector<VkImage> _swapchainImages;
         std::vector<VkImageView> _swapchainImageViews;
+        std::vector<VmaAllocation> _offscreenAllocations;  // headless only
 
         // Descriptions & layout
         VkDescriptorSetLayout _mrtSetLayout{};
@@ -154,9 +276,19 @@ class Renderer {
         VkPipelineLayout _compPipelineLayout{};
         VkPipeline _compPipeline{};
 
+        // set 0 per flight cull lists, set 1 global materials and textures
+        VkDescriptorSetLayout _cullSetLayout{};
+        VkDescriptorSetLayout _bindlessSetLayout{};
+        VkDescriptorPool _bindlessDescPool{};
+        VkDescriptorSet _bindlessSet{};
+        BufferResource _materialBuffer;  // GpuMaterialData per material slot
+        VkPipelineLayout _cullPipelineLayout{};
+        VkPipeline _cullPipeline{};
+        VkPipelineLayout _mrtIndirectPipelineLayout{};
+        VkPipeline _mrtIndirectPipeline{};
+
         // Resources
         VkCommandPool _renderCmdPool{};
-        VkCommandPool _oneTimeCmdPool{};
         VkDescriptorPool _globalDescPool{};
         std::vector<FlightResource *> _flightResources;
 };
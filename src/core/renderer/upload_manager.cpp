@@ -0,0 +1,281 @@
+#include "upload_manager.hpp"
+
+#include "creation_helper.hpp"
+
+namespace luna {
+
+// smallest ring, a chunk is a quarter of it so a few batches can be in flight
+static constexpr VkDeviceSize MIN_RING_SIZE = 1 << 20;
+static constexpr VkDeviceSize BUFFER_STAGING_ALIGN = 16;
+
+// barrier on the transfer queue, nothing after the copy runs on this queue so the release side
+// ends at bottom of pipe, graphics is ordered by the timeline wait
+static void imageBarrier(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout,
+                         VkImageLayout newLayout, VkPipelineStageFlags srcStage,
+                         VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+                         VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;  // concurrent, no ownership transfer
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+bool UploadManager::initialise(VkDevice device, VmaAllocator allocator, VkQueue queue,
+                               uint32_t queueFamily, uint32_t graphicsQueueFamily,
+                               VkDeviceSize ringSize) {
+    auto l = SLog::get();
+    _device = device;
+    _allocator = allocator;
+    _queue = queue;
+    _families = {queueFamily, graphicsQueueFamily};
+
+    VkSemaphoreTypeCreateInfo typeInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+    VkSemaphoreCreateInfo semInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &typeInfo,
+    };
+    if (vkCreateSemaphore(_device, &semInfo, nullptr, &_timeline) != VK_SUCCESS) {
+        l->error("Failed to create upload timeline semaphore");
+        return false;
+    }
+
+    // staging ring, mapped for its whole lifetime
+    _ringSize = std::max(ringSize, MIN_RING_SIZE);
+    _chunkSize = _ringSize / 4;
+    VkBufferCreateInfo ringInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = _ringSize,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,  // only touched by the transfer queue
+    };
+    VmaAllocationCreateInfo ringAllocInfo = CreationHelper::createStagingAllocInfo();
+    VmaAllocationInfo ringAllocResult;
+    if (vmaCreateBuffer(_allocator, &ringInfo, &ringAllocInfo, &_ring, &_ringAlloc,
+                        &ringAllocResult) != VK_SUCCESS) {
+        l->error(fmt::format("Failed to create {:d} bytes staging ring", _ringSize));
+        return false;
+    }
+    _ringData = static_cast<unsigned char *>(ringAllocResult.pMappedData);
+
+    l->info(fmt::format("upload queue family {:d}{:s}, staging ring {:d} MB", queueFamily,
+                        isDedicated() ? " (dedicated transfer)" : " (shared with graphics)",
+                        _ringSize >> 20));
+    return true;
+}
+
+void UploadManager::shutdown() {
+    if (_device == VK_NULL_HANDLE) return;
+    flush();
+    waitIdle();
+    collect();
+    for (auto &batch : _free) vkDestroyCommandPool(_device, batch->pool, nullptr);
+    for (auto &batch : _inFlight) vkDestroyCommandPool(_device, batch->pool, nullptr);
+    _free.clear();
+    _inFlight.clear();
+    vmaDestroyBuffer(_allocator, _ring, _ringAlloc);
+    vkDestroySemaphore(_device, _timeline, nullptr);
+    _device = VK_NULL_HANDLE;
+}
+
+UploadManager::Batch &UploadManager::openBatch() {
+    if (_open != nullptr) return *_open;
+    auto l = SLog::get();
+    if (!_free.empty()) {
+        _open = std::move(_free.back());
+        _free.pop_back();
+        l->vk_res(vkResetCommandPool(_device, _open->pool, 0));
+    } else {
+        _open = std::make_unique<Batch>();
+        VkCommandPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = _families[0],
+        };
+        l->vk_res(vkCreateCommandPool(_device, &poolInfo, nullptr, &_open->pool));
+        VkCommandBufferAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = _open->pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+        l->vk_res(vkAllocateCommandBuffers(_device, &allocInfo, &_open->cmd));
+    }
+    VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    l->vk_res(vkBeginCommandBuffer(_open->cmd, &beginInfo));
+    return *_open;
+}
+
+VkDeviceSize UploadManager::stage(const void *data, VkDeviceSize size, VkDeviceSize align) {
+    while (true) {
+        // nothing in use, start a fresh lap so the whole buffer is available
+        if (_ringHead == _ringTail && _ringHead % _ringSize != 0) {
+            _ringHead = _ringTail = _ringHead - _ringHead % _ringSize + _ringSize;
+        }
+        uint64_t lapStart = _ringHead - _ringHead % _ringSize;
+        VkDeviceSize local = (_ringHead - lapStart + align - 1) / align * align;
+        // never straddle the end of the buffer, the rest of this lap is skipped
+        if (local + size > _ringSize) {
+            lapStart += _ringSize;
+            local = 0;
+        }
+        uint64_t end = lapStart + local + size;
+        if (end - _ringTail <= _ringSize) {
+            _ringHead = end;
+            memcpy(_ringData + local, data, size);
+            vmaFlushAllocation(_allocator, _ringAlloc, local, size);
+            return local;
+        }
+        waitForRingSpace();
+    }
+}
+
+void UploadManager::waitForRingSpace() {
+    // open batch may hold the space, it has to be submitted to ever give it back
+    flush();
+    if (_inFlight.empty()) return;
+    _ringStalls++;
+    VkSemaphoreWaitInfo waitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &_timeline,
+        .pValues = &_inFlight.front()->timelineValue,
+    };
+    vkWaitSemaphores(_device, &waitInfo, UINT64_MAX);
+    collect();
+}
+
+void UploadManager::uploadBuffer(const void *data, VkDeviceSize size, VkBuffer dst,
+                                 VkDeviceSize dstOffset) {
+    auto bytes = static_cast<const unsigned char *>(data);
+    for (VkDeviceSize done = 0; done < size;) {
+        VkDeviceSize piece = std::min(size - done, _chunkSize);
+        // staging may submit the open batch, record into whichever is open afterwards
+        VkDeviceSize src = stage(bytes + done, piece, BUFFER_STAGING_ALIGN);
+        VkBufferCopy region{.srcOffset = src, .dstOffset = dstOffset + done, .size = piece};
+        vkCmdCopyBuffer(openBatch().cmd, _ring, dst, 1, &region);
+        done += piece;
+    }
+}
+
+void UploadManager::uploadImage(const void *data, VkDeviceSize size, VkImage dst,
+                                VkExtent2D extent) {
+    auto l = SLog::get();
+    if (extent.width == 0 || extent.height == 0) return;
+    VkDeviceSize rowSize = size / extent.height;
+    // buffer offset of a buffer to image copy must be a multiple of the texel size and of 4
+    VkDeviceSize align = rowSize / extent.width * 4;
+    if (rowSize > _chunkSize) {
+        l->error(fmt::format("image row of {:d} bytes doesn't fit the staging ring", rowSize));
+        return;
+    }
+    auto rowsPerChunk = static_cast<uint32_t>(_chunkSize / rowSize);
+
+    imageBarrier(openBatch().cmd, dst, VK_IMAGE_LAYOUT_UNDEFINED,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                 VK_ACCESS_NONE, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+    // whole rows per chunk, layout stays transfer dst across batches on the same queue
+    auto bytes = static_cast<const unsigned char *>(data);
+    for (uint32_t row = 0; row < extent.height;) {
+        uint32_t rows = std::min(rowsPerChunk, extent.height - row);
+        VkDeviceSize src = stage(bytes + row * rowSize, rows * rowSize, align);
+        VkBufferImageCopy region{};
+        region.bufferOffset = src;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, static_cast<int32_t>(row), 0};
+        region.imageExtent = {extent.width, rows, 1};
+        vkCmdCopyBufferToImage(openBatch().cmd, _ring, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               1, &region);
+        row += rows;
+    }
+
+    imageBarrier(openBatch().cmd, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                 VK_ACCESS_NONE);
+}
+
+void UploadManager::copyBuffer(VkBuffer src, VkBuffer dst,
+                               const std::vector<VkBufferCopy> &regions) {
+    if (regions.empty()) return;
+    VkCommandBuffer cmd = openBatch().cmd;
+    // earlier copies may have written the source, on this or a previous batch
+    VkMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+    };
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                         &barrier, 0, nullptr, 0, nullptr);
+    vkCmdCopyBuffer(cmd, src, dst, static_cast<uint32_t>(regions.size()), regions.data());
+}
+
+uint64_t UploadManager::flush() {
+    if (_open == nullptr) return _lastSubmitted;
+    auto l = SLog::get();
+    l->vk_res(vkEndCommandBuffer(_open->cmd));
+
+    _open->timelineValue = _lastSubmitted + 1;
+    _open->ringEnd = _ringHead;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &_open->timelineValue,
+    };
+    VkSubmitInfo submitInfo{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineInfo,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &_open->cmd,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &_timeline,
+    };
+    l->vk_res(vkQueueSubmit(_queue, 1, &submitInfo, VK_NULL_HANDLE));
+
+    _lastSubmitted = _open->timelineValue;
+    _inFlight.push_back(std::move(_open));
+    return _lastSubmitted;
+}
+
+void UploadManager::collect() {
+    if (_inFlight.empty()) return;
+    uint64_t completed = 0;
+    vkGetSemaphoreCounterValue(_device, _timeline, &completed);
+    size_t done = 0;
+    while (done < _inFlight.size() && _inFlight[done]->timelineValue <= completed) {
+        _ringTail = std::max(_ringTail, _inFlight[done]->ringEnd);
+        _free.push_back(std::move(_inFlight[done]));
+        done++;
+    }
+    _inFlight.erase(_inFlight.begin(), _inFlight.begin() + static_cast<ptrdiff_t>(done));
+}
+
+void UploadManager::waitIdle() {
+    if (_lastSubmitted == 0) return;
+    VkSemaphoreWaitInfo waitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &_timeline,
+        .pValues = &_lastSubmitted,
+    };
+    vkWaitSemaphores(_device, &waitInfo, UINT64_MAX);
+}
+
+}  // namespace luna
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "vk_mem_alloc.h"
+
+#include "utils/common.hpp"
+
+// Batched asynchronous cpu -> gpu transfers
+// copies and layout transitions are recorded into the open batch instead of one submit and fence
+// wait each, flush() submits the batch on the transfer queue (a transfer only family when the
+// device has one) and signals a timeline semaphore, graphics submission waits on the last flushed
+// value on the gpu, so no cpu thread blocks for an upload
+// source bytes go through one persistently mapped staging ring, a batch gives its part of the
+// ring back once the timeline has passed its value, data larger than a chunk is split across
+// several copies (and batches when the ring is full, the only case that waits on the gpu)
+// render thread only
+
+namespace luna {
+
+class UploadManager {
+    public:
+        bool initialise(VkDevice device, VmaAllocator allocator, VkQueue queue,
+                        uint32_t queueFamily, uint32_t graphicsQueueFamily,
+                        VkDeviceSize ringSize);
+        void shutdown();
+
+        // staging copy of data, recorded into the open batch
+        void uploadBuffer(const void *data, VkDeviceSize size, VkBuffer dst,
+                          VkDeviceSize dstOffset = 0);
+        // whole single mip image, tightly packed rows, left in shader read only layout
+        void uploadImage(const void *data, VkDeviceSize size, VkImage dst, VkExtent2D extent);
+        // gpu side copy, ordered after every upload recorded so far
+        void copyBuffer(VkBuffer src, VkBuffer dst, const std::vector<VkBufferCopy> &regions);
+
+        // submit the open batch, return the value graphics work has to wait on
+        uint64_t flush();
+        // recycle batches the gpu has finished
+        void collect();
+        // block until every flushed batch finished, teardown only
+        void waitIdle();
+
+        // resources written here and read by graphics queue are shared between both families
+        template <class CreateInfo>
+        void applySharing(CreateInfo &info) const {
+            if (!isDedicated()) return;
+            info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            info.queueFamilyIndexCount = static_cast<uint32_t>(_families.size());
+            info.pQueueFamilyIndices = _families.data();
+        }
+
+        [[nodiscard]] VkSemaphore getTimeline() const { return _timeline; }
+        [[nodiscard]] uint64_t getLastSubmitted() const { return _lastSubmitted; }
+        [[nodiscard]] bool isDedicated() const { return _families[0] != _families[1]; }
+        [[nodiscard]] VkDeviceSize getRingSize() const { return _ringSize; }
+        [[nodiscard]] VkDeviceSize getRingUsed() const { return _ringHead - _ringTail; }
+        [[nodiscard]] uint32_t getRingStalls() const { return _ringStalls; }
+
+    private:
+        struct Batch {
+                VkCommandPool pool{};
+                VkCommandBuffer cmd{};
+                uint64_t timelineValue = 0;
+                uint64_t ringEnd = 0;  // ring head when submitted
+        };
+
+        // begin recording a free (or new) batch if none is open
+        Batch &openBatch();
+        // copy data into the ring, return its offset in the ring buffer
+        // waits for the oldest batch when there is no room
+        VkDeviceSize stage(const void *data, VkDeviceSize size, VkDeviceSize align);
+        void waitForRingSpace();
+
+        VkDevice _device{};
+        VmaAllocator _allocator{};
+        VkQueue _queue{};
+        std::array<uint32_t, 2> _families{};  // transfer, graphics
+        VkSemaphore _timeline{};
+        uint64_t _lastSubmitted = 0;
+
+        // head and tail only grow, offset in the buffer is value modulo size
+        VkBuffer _ring{};
+        VmaAllocation _ringAlloc{};
+        unsigned char *_ringData{};
+        VkDeviceSize _ringSize = 0;
+        VkDeviceSize _chunkSize = 0;  // largest single staging piece
+        uint64_t _ringHead = 0;
+        uint64_t _ringTail = 0;
+        uint32_t _ringStalls = 0;
+
+        std::unique_ptr<Batch> _open;
+        std::vector<std::unique_ptr<Batch>> _inFlight;  // submission order
+        std::vector<std::unique_ptr<Batch>> _free;
+};
+
+}  // namespace luna
@@ -0,0 +1,71 @@
+#include "actor_registry.hpp"
+
+namespace luna {
+
+ActorHandle ActorRegistry::add(const std::shared_ptr<Actor>& actor) {
+    uint32_t index;
+    if (!_freeSlots.empty()) {
+        index = _freeSlots.back();
+        _freeSlots.pop_back();
+    } else {
+        if (_slots.size() >= MAX_ACTOR_COUNT) {
+            auto l = SLog::get();
+            l->error(fmt::format("actor registry is full, max {:d}", MAX_ACTOR_COUNT));
+            return INVALID_ACTOR_HANDLE;
+        }
+        index = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+    }
+
+    Slot& slot = _slots[index];
+    slot.denseIdx = static_cast<uint32_t>(_actors.size());
+    ActorHandle handle = (slot.generation << ACTOR_HANDLE_INDEX_BITS) | index;
+    _actors.push_back(actor);
+    _handles.push_back(handle);
+    return handle;
+}
+
+bool ActorRegistry::remove(ActorHandle handle) {
+    if (get(handle) == nullptr) return false;
+
+    Slot& slot = _slots[actorHandleIndex(handle)];
+    uint32_t denseIdx = slot.denseIdx;
+    // actor (and its components) may reach back into registry on destruction,
+    // keep it alive until bookkeeping is consistent
+    std::shared_ptr<Actor> removed = std::move(_actors[denseIdx]);
+    uint32_t lastIdx = static_cast<uint32_t>(_actors.size() - 1);
+    if (denseIdx != lastIdx) {
+        _actors[denseIdx] = std::move(_actors[lastIdx]);
+        _handles[denseIdx] = _handles[lastIdx];
+        _slots[actorHandleIndex(_handles[denseIdx])].denseIdx = denseIdx;
+    }
+    _actors.pop_back();
+    _handles.pop_back();
+
+    // bump generation so old handles go stale, skip 0 so a handle is never 0
+    slot.denseIdx = NO_DENSE;
+    slot.generation = (slot.generation + 1) & ACTOR_HANDLE_GEN_MASK;
+    if (slot.generation == 0) slot.generation = 1;
+    _freeSlots.push_back(actorHandleIndex(handle));
+    return true;
+}
+
+void ActorRegistry::clear() {
+    // keep generations so handles from previous scene stay stale
+    std::vector<std::shared_ptr<Actor>> removed = std::move(_actors);
+    _freeSlots.clear();
+    for (uint32_t i = 0; i < _slots.size(); i++) {
+        Slot& slot = _slots[i];
+        if (slot.denseIdx != NO_DENSE) {
+            slot.denseIdx = NO_DENSE;
+            slot.generation = (slot.generation + 1) & ACTOR_HANDLE_GEN_MASK;
+            if (slot.generation == 0) slot.generation = 1;
+        }
+        _freeSlots.push_back(static_cast<uint32_t>(_slots.size()) - 1 - i);
+    }
+    _actors.clear();
+    _handles.clear();
+    removed.clear();
+}
+
+}  // namespace luna
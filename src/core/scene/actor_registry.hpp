@@ -0,0 +1,76 @@
+#pragma once
+
+#include "utils/common.hpp"
+
+// Slot map for actors, replaces unordered_map<int, shared_ptr<Actor>>
+// handle = generation (high 12 bits) | slot index (low 20 bits), 0 is never a valid handle
+// lookup is an index + generation compare, iteration walks a packed array
+
+namespace luna {
+
+class Actor;
+
+using ActorHandle = uint32_t;
+
+constexpr ActorHandle INVALID_ACTOR_HANDLE = 0;
+constexpr uint32_t ACTOR_HANDLE_INDEX_BITS = 20;
+constexpr uint32_t ACTOR_HANDLE_INDEX_MASK = (1u << ACTOR_HANDLE_INDEX_BITS) - 1;
+constexpr uint32_t ACTOR_HANDLE_GEN_MASK = (1u << (32 - ACTOR_HANDLE_INDEX_BITS)) - 1;
+constexpr uint32_t MAX_ACTOR_COUNT = ACTOR_HANDLE_INDEX_MASK + 1;
+
+constexpr uint32_t actorHandleIndex(ActorHandle handle) { return handle & ACTOR_HANDLE_INDEX_MASK; }
+constexpr uint32_t actorHandleGeneration(ActorHandle handle) {
+    return handle >> ACTOR_HANDLE_INDEX_BITS;
+}
+
+class ActorRegistry {
+    public:
+        // returns INVALID_ACTOR_HANDLE when the registry is full
+        ActorHandle add(const std::shared_ptr<Actor>& actor);
+        // swap remove, invalidates handle and order of dense array
+        bool remove(ActorHandle handle);
+        void clear();
+        void reserve(size_t count) {
+            _slots.reserve(count);
+            _actors.reserve(count);
+            _handles.reserve(count);
+        }
+
+        // nullptr for stale or invalid handle
+        [[nodiscard]] Actor* get(ActorHandle handle) const {
+            uint32_t index = actorHandleIndex(handle);
+            if (index >= _slots.size()) return nullptr;
+            const Slot& slot = _slots[index];
+            if (slot.generation != actorHandleGeneration(handle) || slot.denseIdx == NO_DENSE) {
+                return nullptr;
+            }
+            return _actors[slot.denseIdx].get();
+        }
+        [[nodiscard]] std::shared_ptr<Actor> getShared(ActorHandle handle) const {
+            Actor* a = get(handle);
+            return a == nullptr ? nullptr : _actors[_slots[actorHandleIndex(handle)].denseIdx];
+        }
+        [[nodiscard]] bool isValid(ActorHandle handle) const { return get(handle) != nullptr; }
+
+        // packed storage, index loop is safe against add during iteration
+        [[nodiscard]] const std::vector<std::shared_ptr<Actor>>& getActors() const {
+            return _actors;
+        }
+        [[nodiscard]] ActorHandle getHandleAt(size_t denseIdx) const { return _handles[denseIdx]; }
+        [[nodiscard]] size_t size() const { return _actors.size(); }
+
+    private:
+        static constexpr uint32_t NO_DENSE = UINT32_MAX;
+
+        struct Slot {
+                uint32_t generation = 1;
+                uint32_t denseIdx = NO_DENSE;
+        };
+
+        std::vector<Slot> _slots;
+        std::vector<uint32_t> _freeSlots;
+        std::vector<std::shared_ptr<Actor>> _actors;  // dense
+        std::vector<ActorHandle> _handles;            // dense, parallel to _actors
+};
+
+}  // namespace luna
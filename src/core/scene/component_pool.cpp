@@ -0,0 +1,58 @@
+#include "component_pool.hpp"
+
+#include "core/profile/profiler.hpp"
+
+namespace luna {
+
+void ComponentPools::update(float deltaTime, uint64_t step, std::vector<Component*>& unpooled) {
+    // distinct update order across every pool and unpooled component, ascending
+    _bucketOrders.clear();
+    for (ComponentPoolBase* pool : _order) {
+        pool->prepareBuckets(_bucketOrders);
+    }
+    std::stable_sort(unpooled.begin(), unpooled.end(), [](const Component* a, const Component* b) {
+        return a->getUpdateOrder() < b->getUpdateOrder();
+    });
+    for (const Component* c : unpooled) {
+        _bucketOrders.push_back(c->getUpdateOrder());
+    }
+    std::sort(_bucketOrders.begin(), _bucketOrders.end());
+    _bucketOrders.erase(std::unique(_bucketOrders.begin(), _bucketOrders.end()),
+                        _bucketOrders.end());
+
+    // each bucket is fully done (parallel chunks joined) before the next one starts
+    size_t unpooledIdx = 0;
+    for (int order : _bucketOrders) {
+        for (ComponentPoolBase* pool : _order) {
+            PROFILE_SCOPE(pool->name());
+            pool->updateBucket(order, deltaTime, step, *_scheduler);
+        }
+        // unpooled component may touch anything, always serial
+        for (; unpooledIdx < unpooled.size() && unpooled[unpooledIdx]->getUpdateOrder() == order;
+             unpooledIdx++) {
+            Component* c = unpooled[unpooledIdx];
+            float tierDeltaTime;
+            if (c->_tier.advance(step, deltaTime, tierDeltaTime)) c->update(tierDeltaTime);
+        }
+    }
+}
+
+void ComponentPools::postUpdate() {
+    for (ComponentPoolBase* pool : _order) {
+        pool->postUpdate(*_scheduler);
+    }
+}
+
+void ComponentPools::preRender(float alpha) {
+    for (ComponentPoolBase* pool : _order) {
+        pool->preRender(alpha, *_scheduler);
+    }
+}
+
+void ComponentPools::processInput(const struct InputState& keyState) {
+    for (ComponentPoolBase* pool : _order) {
+        pool->processInput(keyState);
+    }
+}
+
+}  // namespace luna
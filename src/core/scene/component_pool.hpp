@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include "utils/common.hpp"
+#include "components/component.hpp"
+#include "core/task/task_scheduler.hpp"
+#include "core/scene/object_arena.hpp"
+
+// Per type component storage
+// components of a pooled type live in fixed size chunks (address stays stable) and a dense
+// pointer list is walked once per pass, calling the concrete override without virtual dispatch
+// actor and script still hold shared_ptr, the deleter hands memory back to the pool
+// update runs in buckets of equal update order across every actor, a bucket finishes before the
+// next one starts, pools flagged parallel spread a bucket over task scheduler workers
+// passes only walk components that opted in to tick, the list is rebuilt lazily on change
+// update follows the owner update tier, a component not due this step only accumulates delta
+// shared_ptr control blocks (and unpooled components) come from an arena, not the heap
+
+namespace luna {
+
+constexpr uint32_t COMPONENT_CHUNK_SIZE = 256;
+constexpr int COMPONENT_PARALLEL_GRAIN = 64;
+
+// parallel contract: update/postUpdate/preRender only write the component itself and its own
+// owner transform, and at most one component of the type per actor
+enum ComponentPoolFlag { EPoolSerial = 0, EPoolParallel = 1 };
+
+class ComponentPoolBase {
+    public:
+        virtual ~ComponentPoolBase() = default;
+
+        // sort by update order if membership changed, append each distinct order
+        virtual void prepareBuckets(std::vector<int>& orders) = 0;
+        virtual void updateBucket(int order, float deltaTime, uint64_t step,
+                                  TaskScheduler& scheduler) = 0;
+        virtual void postUpdate(TaskScheduler& scheduler) = 0;
+        virtual void preRender(float alpha, TaskScheduler& scheduler) = 0;
+        virtual void processInput(const struct InputState& keyState) = 0;
+        [[nodiscard]] virtual size_t size() const = 0;
+        [[nodiscard]] virtual size_t tickingSize() const = 0;
+        [[nodiscard]] virtual const char* name() const = 0;
+
+        // safe from worker threads, applied by the next pass on the game thread
+        void markTickDirty() { _tickDirty.store(true, std::memory_order_relaxed); }
+
+    protected:
+        std::atomic<bool> _tickDirty{false};
+};
+
+template <class T>
+class ComponentPool final : public ComponentPoolBase {
+    public:
+        ComponentPool(const char* name, ComponentPoolFlag flag, ObjectArena* arena)
+            : _name(name), _flag(flag), _arena(arena) {}
+        ~ComponentPool() override {
+            if (!_alive.empty()) {
+                auto l = SLog::get();
+                l->error(fmt::format("component pool {:s} destroyed with {:d} alive", _name,
+                                     _alive.size()));
+            }
+        }
+
+        template <class... Args>
+        std::shared_ptr<T> create(Args&&... args) {
+            uint32_t slot;
+            if (!_freeSlots.empty()) {
+                slot = _freeSlots.back();
+                _freeSlots.pop_back();
+            } else {
+                if (_slotCount == _chunks.size() * COMPONENT_CHUNK_SIZE) {
+                    _chunks.push_back(std::make_unique<Chunk>());
+                }
+                slot = _slotCount++;
+                _denseIdx.push_back(0);
+                _tickIdx.push_back(NOT_TICKING);
+            }
+
+            T* comp = new (slotPtr(slot)) T(std::forward<Args>(args)...);
+            comp->_poolSlot = slot;
+            comp->_pooled = true;
+            comp->_pool = this;
+            if (comp->isTickEnabled()) markTickDirty();
+            _denseIdx[slot] = static_cast<uint32_t>(_alive.size());
+            _alive.push_back(comp);
+            return std::shared_ptr<T>(
+                comp, [this](T* c) { destroy(c); }, ArenaAllocator<T>(_arena));
+        }
+
+        void prepareBuckets(std::vector<int>& orders) override {
+            refreshTicking();
+            for (size_t i = 0; i < _tickingOrders.size(); i++) {
+                if (i == 0 || _tickingOrders[i] != _tickingOrders[i - 1]) {
+                    orders.push_back(_tickingOrders[i]);
+                }
+            }
+        }
+
+        void updateBucket(int order, float deltaTime, uint64_t step,
+                          TaskScheduler& scheduler) override {
+            // sorted by prepareBuckets, bucket is a contiguous range, orders stay valid when an
+            // entry is nulled by destroy mid pass
+            auto first = std::lower_bound(_tickingOrders.begin(), _tickingOrders.end(), order);
+            auto last = std::upper_bound(first, _tickingOrders.end(), order);
+            forEach(first - _tickingOrders.begin(), last - first, scheduler,
+                    [deltaTime, step](T* c) {
+                        float tierDeltaTime;
+                        if (c->_tier.advance(step, deltaTime, tierDeltaTime)) {
+                            c->T::update(tierDeltaTime);
+                        }
+                    });
+        }
+        void postUpdate(TaskScheduler& scheduler) override {
+            refreshTicking();
+            forEach(0, _ticking.size(), scheduler, [](T* c) { c->T::postUpdate(); });
+        }
+        void preRender(float alpha, TaskScheduler& scheduler) override {
+            refreshTicking();
+            forEach(0, _ticking.size(), scheduler, [alpha](T* c) { c->T::preRender(alpha); });
+        }
+        void processInput(const struct InputState& keyState) override {
+            refreshTicking();
+            for (size_t i = 0; i < _ticking.size(); i++) {
+                T* c = _ticking[i];
+                if (c != nullptr && c->isOwnerActive()) c->T::processInput(keyState);
+            }
+        }
+
+        [[nodiscard]] size_t size() const override { return _alive.size(); }
+        [[nodiscard]] size_t tickingSize() const override { return _ticking.size(); }
+        [[nodiscard]] const char* name() const override { return _name; }
+
+    private:
+        static constexpr uint32_t NOT_TICKING = UINT32_MAX;
+
+        struct Chunk {
+                alignas(T) std::byte storage[sizeof(T) * COMPONENT_CHUNK_SIZE];
+        };
+
+        // parallelFor returns after every chunk finished, that is the barrier
+        template <class Fn>
+        void forEach(size_t first, size_t count, TaskScheduler& scheduler, const Fn& fn) {
+            if (_flag == EPoolParallel) {
+                T** comps = _ticking.data() + first;
+                scheduler.parallelFor(static_cast<int>(count), COMPONENT_PARALLEL_GRAIN,
+                                      [comps, &fn](int begin, int end) {
+                                          for (int i = begin; i < end; i++) {
+                                              T* c = comps[i];
+                                              if (c != nullptr && c->isOwnerActive()) fn(c);
+                                          }
+                                      });
+            } else {
+                // index loop, a serial component may spawn or destroy another of the same type,
+                // destroyed entries are nulled and new ones only join on the next refresh
+                for (size_t i = first; i < first + count && i < _ticking.size(); i++) {
+                    T* c = _ticking[i];
+                    if (c != nullptr && c->isOwnerActive()) fn(c);
+                }
+            }
+        }
+
+        // ticking components sorted by update order so an update bucket is a contiguous range
+        void refreshTicking() {
+            if (!_tickDirty.exchange(false, std::memory_order_relaxed)) return;
+            for (T* c : _ticking) {
+                if (c != nullptr) _tickIdx[c->_poolSlot] = NOT_TICKING;
+            }
+            _ticking.clear();
+            _tickingOrders.clear();
+            for (T* c : _alive) {
+                if (c->isTickEnabled()) _ticking.push_back(c);
+            }
+            std::stable_sort(_ticking.begin(), _ticking.end(), [](const T* a, const T* b) {
+                return a->getUpdateOrder() < b->getUpdateOrder();
+            });
+            for (uint32_t i = 0; i < _ticking.size(); i++) {
+                _tickIdx[_ticking[i]->_poolSlot] = i;
+                _tickingOrders.push_back(_ticking[i]->getUpdateOrder());
+            }
+        }
+
+        void* slotPtr(uint32_t slot) {
+            return _chunks[slot / COMPONENT_CHUNK_SIZE]->storage +
+                   sizeof(T) * (slot % COMPONENT_CHUNK_SIZE);
+        }
+
+        void destroy(T* comp) {
+            uint32_t slot = comp->_poolSlot;
+            // may run inside a pass walking _ticking, null the entry so it's skipped
+            if (_tickIdx[slot] != NOT_TICKING) {
+                _ticking[_tickIdx[slot]] = nullptr;
+                _tickIdx[slot] = NOT_TICKING;
+                markTickDirty();
+            }
+            comp->~T();
+
+            // swap remove from dense list
+            uint32_t idx = _denseIdx[slot];
+            T* last = _alive.back();
+            _alive[idx] = last;
+            _denseIdx[last->_poolSlot] = idx;
+            _alive.pop_back();
+            _freeSlots.push_back(slot);
+        }
+
+        const char* _name;
+        ComponentPoolFlag _flag;
+        ObjectArena* _arena;  // control blocks
+        std::vector<std::unique_ptr<Chunk>> _chunks;
+        uint32_t _slotCount = 0;
+        std::vector<uint32_t> _freeSlots;
+        std::vector<uint32_t> _denseIdx;  // slot -> index in _alive
+        std::vector<uint32_t> _tickIdx;   // slot -> index in _ticking
+        std::vector<T*> _alive;           // every component of the pool
+        std::vector<T*> _ticking;  // opted in to tick, sorted by update order, null if destroyed
+        std::vector<int> _tickingOrders;  // update order of each _ticking entry
+};
+
+class ComponentPools {
+    public:
+        // registration order is the system update order
+        template <class T>
+        void registerPool(const char* name, ComponentPoolFlag flag = EPoolSerial) {
+            ComponentTypeId id = componentTypeId<T>();
+            if (_pools[id] != nullptr) {
+                auto l = SLog::get();
+                l->error(fmt::format("component pool {:s} already registered", name));
+                return;
+            }
+            _pools[id] = std::make_unique<ComponentPool<T>>(name, flag, &_arena);
+            _order.push_back(_pools[id].get());
+        }
+
+        // pooled if the type is registered, arena allocation otherwise
+        template <class T, class... Args>
+        std::shared_ptr<T> create(Args&&... args) {
+            ComponentTypeId id = componentTypeId<T>();
+            if (_pools[id] != nullptr) {
+                auto* pool = static_cast<ComponentPool<T>*>(_pools[id].get());
+                return pool->create(std::forward<Args>(args)...);
+            }
+            return std::allocate_shared<T>(ArenaAllocator<T>(&_arena),
+                                           std::forward<Args>(args)...);
+        }
+
+        // system passes over every pool, unpooled components (from actors) join the buckets
+        // step is the simulation step index, drives update tier scheduling
+        void update(float deltaTime, uint64_t step, std::vector<Component*>& unpooled);
+        void postUpdate();
+        void preRender(float alpha);
+        void processInput(const struct InputState& keyState);
+
+        void setTaskScheduler(TaskScheduler* scheduler) { _scheduler = scheduler; }
+
+        [[nodiscard]] const std::vector<ComponentPoolBase*>& getPools() const { return _order; }
+        [[nodiscard]] const ObjectArena& getArena() const { return _arena; }
+
+    private:
+        // declared first so it outlives the pools and their control blocks
+        ObjectArena _arena{"componentArena"};
+        std::array<std::unique_ptr<ComponentPoolBase>, MAX_COMPONENT_TYPES> _pools{};
+        std::vector<ComponentPoolBase*> _order;
+        std::vector<int> _bucketOrders;  // scratch
+        TaskScheduler* _scheduler = nullptr;
+};
+
+}  // namespace luna
@@ -0,0 +1,258 @@
+#include "dynamic_bvh.hpp"
+
+namespace luna {
+
+float Aabb::rayEnter(const glm::vec3& origin, const glm::vec3& invDir, float maxDist) const {
+    glm::vec3 t1 = (min - origin) * invDir;
+    glm::vec3 t2 = (max - origin) * invDir;
+    glm::vec3 tNear = glm::min(t1, t2);
+    glm::vec3 tFar = glm::max(t1, t2);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+    if (exit < enter || enter > maxDist) return -1;
+    return enter;
+}
+
+Aabb Aabb::transform(const Aabb& local, const glm::mat4& m) {
+    glm::vec3 c = m * glm::vec4(local.center(), 1);
+    glm::mat3 absM = glm::mat3(glm::abs(glm::vec3(m[0])), glm::abs(glm::vec3(m[1])),
+                               glm::abs(glm::vec3(m[2])));
+    glm::vec3 e = absM * local.extents();
+    return {c - e, c + e};
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProj) {
+    // rows of the column major matrix
+    glm::vec4 r0{viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]};
+    glm::vec4 r1{viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]};
+    glm::vec4 r2{viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]};
+    glm::vec4 r3{viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]};
+
+    Frustum frustum{};
+    frustum.planes[0] = r3 + r0;  // left
+    frustum.planes[1] = r3 - r0;  // right
+    frustum.planes[2] = r3 + r1;  // bottom
+    frustum.planes[3] = r3 - r1;  // top
+    frustum.planes[4] = r2;       // near, depth is zero to one
+    frustum.planes[5] = r3 - r2;  // far
+    for (glm::vec4& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+Frustum::Result Frustum::classify(const Aabb& box) const {
+    glm::vec3 c = box.center();
+    glm::vec3 e = box.extents();
+    Result result = EInside;
+    for (const glm::vec4& plane : planes) {
+        glm::vec3 n = plane;
+        float dist = glm::dot(n, c) + plane.w;
+        float radius = glm::dot(glm::abs(n), e);
+        if (dist + radius < 0) return EOutside;
+        if (dist - radius < 0) result = EIntersect;
+    }
+    return result;
+}
+
+bool Frustum::overlapsSphere(const glm::vec3& c, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (glm::dot(glm::vec3(plane), c) + plane.w < -radius) return false;
+    }
+    return true;
+}
+
+int32_t DynamicBvh::createProxy(const Aabb& box, ActorHandle owner, void* userData,
+                                uint32_t category) {
+    int32_t proxy = allocateNode();
+    Node& node = _nodes[proxy];
+    node.box = {box.min - glm::vec3(BVH_FAT_MARGIN), box.max + glm::vec3(BVH_FAT_MARGIN)};
+    node.tight = box;
+    node.owner = owner;
+    node.userData = userData;
+    node.category = category;
+    insertLeaf(proxy);
+    _proxyCount++;
+    return proxy;
+}
+
+void DynamicBvh::destroyProxy(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    _proxyCount--;
+}
+
+bool DynamicBvh::moveProxy(int32_t proxy, const Aabb& box) {
+    _nodes[proxy].tight = box;
+    if (_nodes[proxy].box.contains(box)) return false;
+    removeLeaf(proxy);
+    _nodes[proxy].box = {box.min - glm::vec3(BVH_FAT_MARGIN),
+                         box.max + glm::vec3(BVH_FAT_MARGIN)};
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicBvh::clear() {
+    _nodes.clear();
+    _root = NULL_NODE;
+    _freeList = NULL_NODE;
+    _proxyCount = 0;
+}
+
+int32_t DynamicBvh::allocateNode() {
+    if (_freeList == NULL_NODE) {
+        _nodes.emplace_back();
+        return static_cast<int32_t>(_nodes.size() - 1);
+    }
+    int32_t node = _freeList;
+    _freeList = _nodes[node].parent;
+    _nodes[node] = Node{};
+    return node;
+}
+
+void DynamicBvh::freeNode(int32_t node) {
+    _nodes[node] = Node{};
+    _nodes[node].height = -1;
+    _nodes[node].parent = _freeList;
+    _freeList = node;
+}
+
+void DynamicBvh::insertLeaf(int32_t leaf) {
+    if (_root == NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // descend towards the sibling with the lowest surface area increase
+    Aabb leafBox = _nodes[leaf].box;
+    int32_t index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const Node& node = _nodes[index];
+        float area = node.box.surfaceArea();
+        float combinedArea = Aabb::merge(node.box, leafBox).surfaceArea();
+        // pair leaf with this node
+        float cost = 2 * combinedArea;
+        // every ancestor below here grows by at least this much
+        float inheritance = 2 * (combinedArea - area);
+        auto descendCost = [&](int32_t child) {
+            const Node& c = _nodes[child];
+            float merged = Aabb::merge(leafBox, c.box).surfaceArea();
+            return (c.isLeaf() ? merged : merged - c.box.surfaceArea()) + inheritance;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = _nodes[sibling].parent;
+    int32_t newParent = allocateNode();  // may grow storage, no node reference held
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+    if (oldParent == NULL_NODE) {
+        _root = newParent;
+    } else if (_nodes[oldParent].child1 == sibling) {
+        _nodes[oldParent].child1 = newParent;
+    } else {
+        _nodes[oldParent].child2 = newParent;
+    }
+    refitUpward(newParent);
+}
+
+void DynamicBvh::removeLeaf(int32_t leaf) {
+    if (leaf == _root) {
+        _root = NULL_NODE;
+        return;
+    }
+
+    // parent goes away, sibling takes its place
+    int32_t parent = _nodes[leaf].parent;
+    int32_t grandParent = _nodes[parent].parent;
+    int32_t sibling =
+        _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+    _nodes[sibling].parent = grandParent;
+    freeNode(parent);
+    if (grandParent == NULL_NODE) {
+        _root = sibling;
+        return;
+    }
+    if (_nodes[grandParent].child1 == parent) {
+        _nodes[grandParent].child1 = sibling;
+    } else {
+        _nodes[grandParent].child2 = sibling;
+    }
+    refitUpward(grandParent);
+}
+
+void DynamicBvh::refitUpward(int32_t index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+        Node& node = _nodes[index];
+        const Node& c1 = _nodes[node.child1];
+        const Node& c2 = _nodes[node.child2];
+        node.box = Aabb::merge(c1.box, c2.box);
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.category = c1.category | c2.category;
+        index = node.parent;
+    }
+}
+
+// rotate the taller grandchild up when children height differs by more than one
+// A(B, C(F, G)) becomes C(A(B, G), F) with F the taller of F and G, mirrored for B
+int32_t DynamicBvh::balance(int32_t iA) {
+    Node& a = _nodes[iA];
+    if (a.isLeaf()) return iA;
+
+    int32_t iB = a.child1;
+    int32_t iC = a.child2;
+    int32_t diff = _nodes[iC].height - _nodes[iB].height;
+    if (diff >= -1 && diff <= 1) return iA;
+
+    // up is the taller child, stay is the other one, both hold on to A
+    bool rotateC = diff > 1;
+    int32_t iUp = rotateC ? iC : iB;
+    int32_t iStay = rotateC ? iB : iC;
+    Node& up = _nodes[iUp];
+    const Node& stay = _nodes[iStay];
+    int32_t iF = up.child1;
+    int32_t iG = up.child2;
+
+    // up replaces A under A's parent
+    up.parent = a.parent;
+    a.parent = iUp;
+    if (up.parent == NULL_NODE) {
+        _root = iUp;
+    } else if (_nodes[up.parent].child1 == iA) {
+        _nodes[up.parent].child1 = iUp;
+    } else {
+        _nodes[up.parent].child2 = iUp;
+    }
+
+    // taller grandchild stays with up, the other one moves down under A
+    if (_nodes[iF].height < _nodes[iG].height) std::swap(iF, iG);
+    const Node& f = _nodes[iF];
+    Node& g = _nodes[iG];
+    up.child1 = iA;
+    up.child2 = iF;
+    if (rotateC) {
+        a.child2 = iG;
+    } else {
+        a.child1 = iG;
+    }
+    g.parent = iA;
+
+    a.box = Aabb::merge(stay.box, g.box);
+    a.height = 1 + std::max(stay.height, g.height);
+    a.category = stay.category | g.category;
+    up.box = Aabb::merge(a.box, f.box);
+    up.height = 1 + std::max(a.height, f.height);
+    up.category = a.category | f.category;
+    return iUp;
+}
+
+}  // namespace luna
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "utils/common.hpp"
+#include "core/scene/actor_registry.hpp"
+
+// Dynamic bounding volume hierarchy over world space boxes
+// leaf stores a fat box (margin around the real one), a move inside the fat box costs nothing,
+// otherwise the leaf is reinserted at the cheapest sibling and ancestors are rotated to balance
+// box, sphere and ray queries re-test the real box at the leaf, frustum culling keeps the fat one
+// internal node carries the union of its children category mask, a query skips whole subtrees
+// queries are read only and may nest, callback returns false to stop
+
+namespace luna {
+
+constexpr float BVH_FAT_MARGIN = 0.2f;
+
+// what a proxy is, query mask selects the categories of interest
+enum SpatialCategory { ESpatialMesh = 1, ESpatialLight = 2, ESpatialAll = 0xFFFFFFFF };
+
+struct Aabb {
+        glm::vec3 min{0};
+        glm::vec3 max{0};
+
+        [[nodiscard]] glm::vec3 center() const { return (min + max) * 0.5f; }
+        [[nodiscard]] glm::vec3 extents() const { return (max - min) * 0.5f; }
+        [[nodiscard]] float surfaceArea() const {
+            glm::vec3 d = max - min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+        [[nodiscard]] bool contains(const Aabb& other) const {
+            return glm::all(glm::lessThanEqual(min, other.min)) &&
+                   glm::all(glm::greaterThanEqual(max, other.max));
+        }
+        [[nodiscard]] bool overlaps(const Aabb& other) const {
+            return glm::all(glm::lessThanEqual(min, other.max)) &&
+                   glm::all(glm::greaterThanEqual(max, other.min));
+        }
+        [[nodiscard]] bool overlapsSphere(const glm::vec3& c, float radius) const {
+            glm::vec3 d = glm::clamp(c, min, max) - c;
+            return glm::dot(d, d) <= radius * radius;
+        }
+        // slab test, entry distance in [0, maxDist] or negative when missed
+        [[nodiscard]] float rayEnter(const glm::vec3& origin, const glm::vec3& invDir,
+                                     float maxDist) const;
+
+        static Aabb merge(const Aabb& a, const Aabb& b) {
+            return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+        }
+        static Aabb fromSphere(const glm::vec3& c, float radius) {
+            return {c - glm::vec3(radius), c + glm::vec3(radius)};
+        }
+        // box around the transformed box, center/extent form, no corner loop
+        static Aabb transform(const Aabb& local, const glm::mat4& m);
+};
+
+// six planes pointing inward, from a (vulkan, zero to one depth) view projection matrix
+struct Frustum {
+        enum Result { EOutside, EIntersect, EInside };
+
+        glm::vec4 planes[6];
+
+        static Frustum fromMatrix(const glm::mat4& viewProj);
+        [[nodiscard]] Result classify(const Aabb& box) const;
+        [[nodiscard]] bool overlapsSphere(const glm::vec3& c, float radius) const;
+};
+
+class DynamicBvh {
+    public:
+        static constexpr int32_t NULL_NODE = -1;
+
+        // return proxy id, stable until destroyed
+        int32_t createProxy(const Aabb& box, ActorHandle owner, void* userData, uint32_t category);
+        void destroyProxy(int32_t proxy);
+        // true when the leaf had to be reinserted
+        bool moveProxy(int32_t proxy, const Aabb& box);
+        void clear();
+
+        [[nodiscard]] ActorHandle getOwner(int32_t proxy) const { return _nodes[proxy].owner; }
+        [[nodiscard]] void* getUserData(int32_t proxy) const { return _nodes[proxy].userData; }
+        [[nodiscard]] const Aabb& getFatAabb(int32_t proxy) const { return _nodes[proxy].box; }
+        [[nodiscard]] const Aabb& getAabb(int32_t proxy) const { return _nodes[proxy].tight; }
+        [[nodiscard]] size_t size() const { return _proxyCount; }
+        [[nodiscard]] int getHeight() const {
+            return _root == NULL_NODE ? 0 : _nodes[_root].height;
+        }
+
+        // fn(int32_t proxy) -> bool, false stops the query
+        template <class Fn>
+        void queryAabb(const Aabb& box, uint32_t mask, Fn&& fn) const {
+            walk(mask, [&box](const Aabb& b) { return b.overlaps(box); }, fn);
+        }
+        template <class Fn>
+        void querySphere(const glm::vec3& center, float radius, uint32_t mask, Fn&& fn) const {
+            walk(mask, [&](const Aabb& b) { return b.overlapsSphere(center, radius); }, fn);
+        }
+        template <class Fn>
+        void forEach(uint32_t mask, Fn&& fn) const {
+            walk(mask, [](const Aabb&) { return true; }, fn);
+        }
+        // subtree fully inside the frustum is reported without further plane tests
+        template <class Fn>
+        void queryFrustum(const Frustum& frustum, uint32_t mask, Fn&& fn) const;
+        // fn(int32_t proxy, float enterDist) -> float, new max distance, 0 stops the cast
+        template <class Fn>
+        void rayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, uint32_t mask,
+                     Fn&& fn) const;
+
+    private:
+        struct Node {
+                Aabb box;  // fat for a leaf, union of children otherwise
+                Aabb tight;  // leaf only, bounds as last reported
+                int32_t parent = NULL_NODE;  // next free node when unused
+                int32_t child1 = NULL_NODE;
+                int32_t child2 = NULL_NODE;
+                int32_t height = 0;  // leaf 0, free -1
+                uint32_t category = 0;
+                ActorHandle owner = INVALID_ACTOR_HANDLE;
+                void* userData = nullptr;
+
+                [[nodiscard]] bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        // inline for typical height, spills to heap for a degenerate tree
+        class Stack {
+            public:
+                void push(int32_t node) {
+                    if (_size < INLINE) {
+                        _inline[_size++] = node;
+                    } else {
+                        _spill.push_back(node);
+                        _size++;
+                    }
+                }
+                int32_t pop() {
+                    _size--;
+                    if (_size < INLINE) return _inline[_size];
+                    int32_t node = _spill.back();
+                    _spill.pop_back();
+                    return node;
+                }
+                [[nodiscard]] bool empty() const { return _size == 0; }
+
+            private:
+                static constexpr size_t INLINE = 64;
+                int32_t _inline[INLINE];
+                std::vector<int32_t> _spill;
+                size_t _size = 0;
+        };
+
+        template <class Test, class Fn>
+        void walk(uint32_t mask, const Test& test, Fn& fn) const {
+            if (_root == NULL_NODE) return;
+            Stack stack;
+            stack.push(_root);
+            while (!stack.empty()) {
+                const Node& node = _nodes[stack.pop()];
+                if ((node.category & mask) == 0 || !test(node.box)) continue;
+                if (node.isLeaf()) {
+                    if (!test(node.tight)) continue;
+                    if (!fn(static_cast<int32_t>(&node - _nodes.data()))) return;
+                } else {
+                    stack.push(node.child1);
+                    stack.push(node.child2);
+                }
+            }
+        }
+
+        int32_t allocateNode();
+        void freeNode(int32_t node);
+        void insertLeaf(int32_t leaf);
+        void removeLeaf(int32_t leaf);
+        // refit box, height and category from leaf parent to root, rotating on the way
+        void refitUpward(int32_t node);
+        int32_t balance(int32_t node);
+
+        std::vector<Node> _nodes;
+        int32_t _root = NULL_NODE;
+        int32_t _freeList = NULL_NODE;
+        size_t _proxyCount = 0;
+};
+
+template <class Fn>
+void DynamicBvh::queryFrustum(const Frustum& frustum, uint32_t mask, Fn&& fn) const {
+    if (_root == NULL_NODE) return;
+    // node index, sign bit marks a subtree already known to be inside
+    Stack stack;
+    stack.push(_root);
+    while (!stack.empty()) {
+        int32_t entry = stack.pop();
+        bool inside = entry < 0;
+        int32_t idx = inside ? ~entry : entry;
+        const Node& node = _nodes[idx];
+        if ((node.category & mask) == 0) continue;
+        if (!inside) {
+            Frustum::Result result = frustum.classify(node.box);
+            if (result == Frustum::EOutside) continue;
+            inside = result == Frustum::EInside;
+        }
+        if (node.isLeaf()) {
+            if (!fn(idx)) return;
+        } else {
+            stack.push(inside ? ~node.child1 : node.child1);
+            stack.push(inside ? ~node.child2 : node.child2);
+        }
+    }
+}
+
+template <class Fn>
+void DynamicBvh::rayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist,
+                         uint32_t mask, Fn&& fn) const {
+    if (_root == NULL_NODE) return;
+    glm::vec3 invDir = 1.0f / dir;
+    Stack stack;
+    stack.push(_root);
+    while (!stack.empty()) {
+        int32_t idx = stack.pop();
+        const Node& node = _nodes[idx];
+        if ((node.category & mask) == 0) continue;
+        float enter = node.box.rayEnter(origin, invDir, maxDist);
+        if (enter < 0) continue;
+        if (node.isLeaf()) {
+            enter = node.tight.rayEnter(origin, invDir, maxDist);
+            if (enter < 0) continue;
+            maxDist = fn(idx, enter);
+            if (maxDist <= 0) return;
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+}  // namespace luna
@@ -0,0 +1,90 @@
+#include "object_arena.hpp"
+
+namespace luna {
+
+BlockPool::BlockPool(size_t blockSize)
+    : _blockSize(blockSize), _blocksPerChunk(std::max<size_t>(1, ARENA_CHUNK_BYTES / blockSize)) {}
+
+BlockPool::~BlockPool() {
+    if (_liveCount != 0) {
+        auto l = SLog::get();
+        l->error(fmt::format("block pool of size {:d} destroyed with {:d} live blocks",
+                             _blockSize, _liveCount));
+    }
+}
+
+void BlockPool::addChunk() {
+    // default new alignment is at least ARENA_BLOCK_ALIGN, block size is a multiple of it
+    auto chunk = std::make_unique<std::byte[]>(_blockSize * _blocksPerChunk);
+    // thread the new blocks onto the free list, first block is handed out first
+    for (size_t i = _blocksPerChunk; i > 0; i--) {
+        auto* node = reinterpret_cast<FreeNode*>(chunk.get() + _blockSize * (i - 1));
+        node->next = _freeList;
+        _freeList = node;
+    }
+    _chunks.push_back(std::move(chunk));
+}
+
+void* BlockPool::allocate() {
+    if (_freeList == nullptr) addChunk();
+    FreeNode* node = _freeList;
+    _freeList = node->next;
+    _liveCount++;
+    return node;
+}
+
+void BlockPool::deallocate(void* ptr) {
+    auto* node = static_cast<FreeNode*>(ptr);
+    node->next = _freeList;
+    _freeList = node;
+    _liveCount--;
+}
+
+void BlockPool::reserve(size_t count) {
+    while (capacity() - _liveCount < count) {
+        addChunk();
+    }
+}
+
+BlockPool& ObjectArena::poolFor(size_t size) {
+    size_t idx = (std::max<size_t>(size, 1) + ARENA_BLOCK_ALIGN - 1) / ARENA_BLOCK_ALIGN - 1;
+    if (_pools[idx] == nullptr) {
+        _pools[idx] = std::make_unique<BlockPool>((idx + 1) * ARENA_BLOCK_ALIGN);
+    }
+    return *_pools[idx];
+}
+
+void* ObjectArena::allocate(size_t size, size_t align) {
+    if (!fits(size, align)) return ::operator new(size, std::align_val_t(align));
+    return poolFor(size).allocate();
+}
+
+void ObjectArena::deallocate(void* ptr, size_t size, size_t align) {
+    if (!fits(size, align)) {
+        ::operator delete(ptr, std::align_val_t(align));
+        return;
+    }
+    poolFor(size).deallocate(ptr);
+}
+
+void ObjectArena::reserve(size_t size, size_t count) {
+    if (fits(size, ARENA_BLOCK_ALIGN)) poolFor(size).reserve(count);
+}
+
+size_t ObjectArena::liveCount() const {
+    size_t count = 0;
+    for (const auto& pool : _pools) {
+        if (pool != nullptr) count += pool->liveCount();
+    }
+    return count;
+}
+
+size_t ObjectArena::capacityBytes() const {
+    size_t bytes = 0;
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        if (_pools[i] != nullptr) bytes += _pools[i]->capacity() * (i + 1) * ARENA_BLOCK_ALIGN;
+    }
+    return bytes;
+}
+
+}  // namespace luna
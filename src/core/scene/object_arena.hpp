@@ -0,0 +1,95 @@
+#pragma once
+
+#include "utils/common.hpp"
+
+// Size class block allocator for actor / component objects and their shared_ptr control blocks
+// memory comes in large chunks kept until the arena dies, a freed block goes on its class free
+// list, so spawning and destroying many actors is a pointer push/pop and doesn't fragment heap
+// not thread safe, allocate and release on the game thread
+
+namespace luna {
+
+constexpr size_t ARENA_BLOCK_ALIGN = 16;
+constexpr size_t ARENA_MAX_BLOCK_SIZE = 2048;  // bigger object falls back to operator new
+constexpr size_t ARENA_CHUNK_BYTES = 64 * 1024;
+
+class BlockPool {
+    public:
+        explicit BlockPool(size_t blockSize);
+        ~BlockPool();
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+
+        void* allocate();
+        void deallocate(void* ptr);
+        // make sure count blocks can be handed out without another chunk allocation
+        void reserve(size_t count);
+
+        [[nodiscard]] size_t liveCount() const { return _liveCount; }
+        [[nodiscard]] size_t capacity() const { return _chunks.size() * _blocksPerChunk; }
+
+    private:
+        struct FreeNode {
+                FreeNode* next;
+        };
+        void addChunk();
+
+        size_t _blockSize;
+        size_t _blocksPerChunk;
+        std::vector<std::unique_ptr<std::byte[]>> _chunks;
+        FreeNode* _freeList = nullptr;
+        size_t _liveCount = 0;
+};
+
+class ObjectArena {
+    public:
+        explicit ObjectArena(const char* name) : _name(name) {}
+
+        void* allocate(size_t size, size_t align);
+        void deallocate(void* ptr, size_t size, size_t align);
+        void reserve(size_t size, size_t count);
+
+        [[nodiscard]] size_t liveCount() const;
+        [[nodiscard]] size_t capacityBytes() const;
+        [[nodiscard]] const char* name() const { return _name; }
+
+    private:
+        static constexpr size_t CLASS_COUNT = ARENA_MAX_BLOCK_SIZE / ARENA_BLOCK_ALIGN;
+
+        [[nodiscard]] static bool fits(size_t size, size_t align) {
+            return size <= ARENA_MAX_BLOCK_SIZE && align <= ARENA_BLOCK_ALIGN;
+        }
+        BlockPool& poolFor(size_t size);
+
+        const char* _name;
+        // lazily created, index = size / ARENA_BLOCK_ALIGN rounded up - 1
+        std::array<std::unique_ptr<BlockPool>, CLASS_COUNT> _pools{};
+};
+
+// std allocator over an arena, for std::allocate_shared and the shared_ptr control block
+template <class T>
+class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        explicit ArenaAllocator(ObjectArena* arena) : _arena(arena) {}
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other.getArena()) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(_arena->allocate(sizeof(T) * n, alignof(T)));
+        }
+        void deallocate(T* ptr, size_t n) { _arena->deallocate(ptr, sizeof(T) * n, alignof(T)); }
+
+        [[nodiscard]] ObjectArena* getArena() const { return _arena; }
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U>& rhs) const {
+            return _arena == rhs.getArena();
+        }
+
+    private:
+        ObjectArena* _arena;
+};
+
+}  // namespace luna
@@ -0,0 +1,81 @@
+#include "prefab.hpp"
+
+#include "core/engine.hpp"
+#include "actors/object/empty.hpp"
+
+namespace luna {
+
+void Prefab::setModel(const std::string &path, const glm::vec3 &upAxis) {
+    _meshSource = {.kind = EMeshSourceModel, .path = path, .upAxis = upAxis};
+    _mesh = nullptr;
+}
+
+void Prefab::setSquarePlane(float sideLength, const glm::vec3 &color) {
+    _meshSource = {.kind = EMeshSourcePlane, .color = color, .size = sideLength};
+    _mesh = nullptr;
+}
+
+void Prefab::setSphere(float radius, int horizontalLine, int verticalLine,
+                       const glm::vec3 &color) {
+    _meshSource = {.kind = EMeshSourceSphere,
+                   .color = color,
+                   .size = radius,
+                   .horizontalLine = horizontalLine,
+                   .verticalLine = verticalLine};
+    _mesh = nullptr;
+}
+
+void Prefab::setBoxBody(const glm::vec3 &halfExtent, bool isStatic, float bounciness) {
+    _bodyShape = EBodyShapeBox;
+    _bodySize = halfExtent;
+    _bodyStatic = isStatic;
+    _bodyBounciness = bounciness;
+}
+
+void Prefab::setSphereBody(float radius, bool isStatic, float bounciness) {
+    _bodyShape = EBodyShapeSphere;
+    _bodySize = glm::vec3{radius, 0, 0};
+    _bodyStatic = isStatic;
+    _bodyBounciness = bounciness;
+}
+
+std::shared_ptr<Actor> Prefab::instantiate(const std::shared_ptr<Engine> &engine,
+                                           const glm::vec3 &pos, const glm::quat &rot) {
+    auto actor = engine->createActor<EmptyActor>();
+    if (actor == nullptr) {
+        auto l = SLog::get();
+        l->error(fmt::format("failed to instantiate prefab {:s}", _name));
+        return nullptr;
+    }
+    // transform first, body is created at owner world position
+    actor->setLocalPosition(pos);
+    actor->setRotation(rot);
+    actor->setScale(_scale);
+
+    if (_meshSource.kind != EMeshSourceNone) {
+        auto meshComp = actor->createComponent<MeshComponent>();
+        if (_mesh != nullptr) {
+            meshComp->setMesh(_mesh, _meshSource);
+        } else {
+            meshComp->loadSource(_meshSource);
+        }
+        meshComp->uploadToGpu();
+        _mesh = meshComp->getMesh();
+    }
+
+    if (_bodyShape != EBodyShapeNone) {
+        auto bodyComp = actor->createComponent<RigidBodyComponent>();
+        bodyComp->setIsStatic(_bodyStatic);
+        bodyComp->setBounciness(_bodyBounciness);
+        if (_bodyShape == EBodyShapeBox) {
+            bodyComp->createBox(_bodySize);
+        } else {
+            bodyComp->createSphere(_bodySize.x);
+        }
+    }
+
+    _instanceCount++;
+    return actor;
+}
+
+}  // namespace luna
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "utils/common.hpp"
+#include "components/graphic/mesh.hpp"
+#include "components/physic/rigidbody.hpp"
+
+// Prefab describes an actor once (mesh source, scale, rigid body) and spawns it many times
+// mesh is loaded and uploaded by the first instance, every later instance only creates its own
+// transform, modal state and physic body, and draws the shared gpu mesh and materials
+
+namespace luna {
+
+class Engine;
+class Actor;
+
+class Prefab {
+    public:
+        explicit Prefab(std::string name = "Prefab") : _name(std::move(name)) {};
+
+        // mesh source, last one set wins
+        void setModel(const std::string &path, const glm::vec3 &upAxis = glm::vec3{0, 1, 0});
+        void setSquarePlane(float sideLength, const glm::vec3 &color = glm::vec3{0, 0.1, 0.9});
+        void setSphere(float radius, int horizontalLine, int verticalLine,
+                       const glm::vec3 &color = glm::vec3{0.3, 0.8, 0.1});
+        void setScale(float scale) { _scale = scale; }
+
+        // per instance physic body, body shape last one set wins
+        void setBoxBody(const glm::vec3 &halfExtent, bool isStatic, float bounciness = 0);
+        void setSphereBody(float radius, bool isStatic, float bounciness = 0);
+
+        // nullptr when actor registry is full
+        std::shared_ptr<Actor> instantiate(const std::shared_ptr<Engine> &engine,
+                                           const glm::vec3 &pos,
+                                           const glm::quat &rot = glm::identity<glm::quat>());
+
+        [[nodiscard]] const std::string &getName() const { return _name; }
+        [[nodiscard]] int getInstanceCount() const { return _instanceCount; }
+
+    private:
+        std::string _name;
+        float _scale = 1;
+        int _instanceCount = 0;
+
+        // mesh
+        MeshSource _meshSource;
+        std::shared_ptr<MeshGpu> _mesh;  // after first instance
+
+        // body
+        BodyShapeKind _bodyShape = EBodyShapeNone;
+        glm::vec3 _bodySize{};  // box half extent, or radius in x
+        bool _bodyStatic = true;
+        float _bodyBounciness = 0;
+};
+
+}  // namespace luna
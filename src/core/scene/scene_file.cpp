@@ -0,0 +1,247 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "scene_file.hpp"
+
+#include "core/engine.hpp"
+#include "core/renderer/renderer.hpp"
+#include "actors/player/camera.hpp"
+#include "actors/object/empty.hpp"
+#include "actors/object/point_light.hpp"
+#include "actors/object/static.hpp"
+#include "components/graphic/mesh.hpp"
+#include "components/physic/rigidbody.hpp"
+#include "utils/mapped_file.hpp"
+
+namespace luna {
+
+template <class T>
+static void writePod(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static void toFloats(const glm::vec3 &v, float *out) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+static glm::vec3 toVec3(const float *v) { return {v[0], v[1], v[2]}; }
+
+static SceneActorRecord makeRecord(Actor *actor, uint32_t parent, std::string &strings) {
+    SceneActorRecord rec{};
+    rec.type = ESceneActorEmpty;
+    rec.parent = parent;
+    toFloats(actor->getLocalPosition(), rec.position);
+    glm::quat rot = actor->getRotation();
+    rec.rotation[0] = rot.x;
+    rec.rotation[1] = rot.y;
+    rec.rotation[2] = rot.z;
+    rec.rotation[3] = rot.w;
+    rec.scale = actor->getScale();
+
+    if (auto *cam = dynamic_cast<CameraActor *>(actor)) {
+        rec.type = ESceneActorCamera;
+        rec.params[0] = cam->getNearDepth();
+        rec.params[1] = cam->getFarDepth();
+        rec.params[2] = cam->getFovY();
+    } else if (auto *light = dynamic_cast<PointLightActor *>(actor)) {
+        rec.type = ESceneActorLight;
+        toFloats(light->getColor(), rec.params);
+        rec.params[3] = light->getRadius();
+    } else if (dynamic_cast<StaticActor *>(actor) != nullptr) {
+        rec.type = ESceneActorStatic;
+    }
+
+    if (auto *mesh = actor->getComponent<MeshComponent>()) {
+        const MeshSource &src = mesh->getSource();
+        rec.meshKind = src.kind;
+        rec.meshPathOffset = static_cast<uint32_t>(strings.size());
+        rec.meshPathLength = static_cast<uint32_t>(src.path.size());
+        strings += src.path;
+        toFloats(src.upAxis, rec.meshUpAxis);
+        toFloats(src.color, rec.meshColor);
+        rec.meshSize = src.size;
+        rec.meshHorizontalLine = src.horizontalLine;
+        rec.meshVerticalLine = src.verticalLine;
+    }
+    if (auto *body = actor->getComponent<RigidBodyComponent>()) {
+        rec.bodyKind = body->getShapeKind();
+        rec.bodyStatic = body->getIsStatic() ? 1 : 0;
+        toFloats(body->getShapeSize(), rec.bodySize);
+        toFloats(body->getRelativePos(), rec.bodyOffset);
+        rec.bodyBounciness = body->getBounciness();
+    }
+    return rec;
+}
+
+bool SceneFile::save(Engine &engine, const std::string &path) {
+    auto l = SLog::get();
+    const ActorRegistry &registry = engine.getActorRegistry();
+
+    // parent before children, depth first from every root
+    std::vector<SceneActorRecord> records;
+    records.reserve(registry.size());
+    std::unordered_map<ActorHandle, uint32_t> recordIdx;
+    recordIdx.reserve(registry.size());
+    std::string strings;
+    std::vector<std::pair<Actor *, uint32_t>> stack;
+    for (const auto &root : registry.getActors()) {
+        if (registry.isValid(root->getParentId())) continue;
+        stack.emplace_back(root.get(), SCENE_NO_PARENT);
+        while (!stack.empty()) {
+            auto [actor, parent] = stack.back();
+            stack.pop_back();
+            if (actor->getState() == Actor::EDead) continue;
+            recordIdx[actor->getId()] = static_cast<uint32_t>(records.size());
+            records.push_back(makeRecord(actor, parent, strings));
+            uint32_t idx = recordIdx[actor->getId()];
+            for (ActorHandle childId : actor->getChildrenIdList()) {
+                Actor *child = registry.get(childId);
+                if (child != nullptr) stack.emplace_back(child, idx);
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        l->error(fmt::format("failed to open scene file {:s} for writing", path));
+        return false;
+    }
+    SceneFileHeader header{};
+    header.magic = SCENE_FILE_MAGIC;
+    header.version = SCENE_FILE_VERSION;
+    header.actorCount = static_cast<uint32_t>(records.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+    const auto &renderer = engine.getRenderer();
+    toFloats(renderer->getClearColor(), header.clearColor);
+    const DirectionalLight &sun = renderer->getDirLight();
+    toFloats(glm::vec3(sun.position), header.sunDir);
+    toFloats(glm::vec3(sun.color), header.sunColor);
+
+    writePod(file, header);
+    file.write(reinterpret_cast<const char *>(records.data()),
+               static_cast<std::streamsize>(records.size() * sizeof(SceneActorRecord)));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    if (!file.good()) {
+        l->error(fmt::format("failed to write scene file {:s}", path));
+        return false;
+    }
+    l->info(fmt::format("saved {:d} actors to {:s}", records.size(), path));
+    return true;
+}
+
+static std::shared_ptr<Actor> createRecordActor(Engine &engine, const SceneActorRecord &rec) {
+    switch (rec.type) {
+        case ESceneActorStatic:
+            // mesh is applied from the record like any other actor
+            return engine.createActor<StaticActor>();
+        case ESceneActorCamera:
+            return engine.createActor<CameraActor>(rec.params[0], rec.params[1], rec.params[2]);
+        case ESceneActorLight:
+            return engine.createActor<PointLightActor>(toVec3(rec.params), rec.scale,
+                                                       rec.params[3]);
+        default:
+            return engine.createActor<EmptyActor>();
+    }
+}
+
+bool SceneFile::load(const std::shared_ptr<Engine> &engine, const std::string &path) {
+    auto l = SLog::get();
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file;
+    if (!file.open(path)) return false;
+    SceneFileHeader header{};
+    if (file.size() < sizeof(header)) {
+        l->error(fmt::format("{:s} is not a scene file", path));
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != SCENE_FILE_MAGIC) {
+        l->error(fmt::format("{:s} is not a scene file", path));
+        return false;
+    }
+    if (header.version != SCENE_FILE_VERSION) {
+        l->error(fmt::format("unsupported scene file version {:d}", header.version));
+        return false;
+    }
+    size_t recordBytes = size_t(header.actorCount) * sizeof(SceneActorRecord);
+    if (file.size() < sizeof(header) + recordBytes + header.stringBytes) {
+        l->error(fmt::format("scene file {:s} is truncated", path));
+        return false;
+    }
+    const uint8_t *recordData = file.data() + sizeof(header);
+    const char *strings = reinterpret_cast<const char *>(recordData + recordBytes);
+
+    const auto &renderer = engine->getRenderer();
+    renderer->setClearColor(toVec3(header.clearColor));
+    renderer->setDirLight(toVec3(header.sunDir), toVec3(header.sunColor));
+
+    // grow storage once, mesh cache makes repeated assets a lookup
+    engine->reserveActors(engine->getActorRegistry().size() + header.actorCount);
+    std::vector<ActorHandle> handles(header.actorCount, INVALID_ACTOR_HANDLE);
+    for (uint32_t i = 0; i < header.actorCount; i++) {
+        SceneActorRecord rec;
+        memcpy(&rec, recordData + size_t(i) * sizeof(SceneActorRecord), sizeof(rec));
+
+        auto actor = createRecordActor(*engine, rec);
+        if (actor == nullptr) {
+            l->error(fmt::format("scene {:s} stopped at actor {:d}, registry full", path, i));
+            return false;
+        }
+        handles[i] = actor->getId();
+        // hierarchy before transform, rigid body is created at the world position
+        if (rec.parent != SCENE_NO_PARENT) {
+            if (rec.parent < i) {
+                actor->setParent(handles[rec.parent]);
+            } else {
+                l->warn(fmt::format("scene actor {:d} has invalid parent {:d}", i, rec.parent));
+            }
+        }
+        actor->setLocalPosition(toVec3(rec.position));
+        actor->setRotation(
+            glm::quat(rec.rotation[3], rec.rotation[0], rec.rotation[1], rec.rotation[2]));
+        actor->setScale(rec.scale);
+
+        if (rec.meshKind != EMeshSourceNone) {
+            MeshSource src{};
+            src.kind = static_cast<MeshSourceKind>(rec.meshKind);
+            if (size_t(rec.meshPathOffset) + rec.meshPathLength <= header.stringBytes) {
+                src.path.assign(strings + rec.meshPathOffset, rec.meshPathLength);
+            }
+            src.upAxis = toVec3(rec.meshUpAxis);
+            src.color = toVec3(rec.meshColor);
+            src.size = rec.meshSize;
+            src.horizontalLine = rec.meshHorizontalLine;
+            src.verticalLine = rec.meshVerticalLine;
+
+            MeshComponent *mesh = actor->getComponent<MeshComponent>();
+            if (mesh == nullptr) mesh = actor->createComponent<MeshComponent>().get();
+            mesh->loadSource(src);
+            mesh->uploadToGpu();
+        }
+        if (rec.bodyKind != EBodyShapeNone) {
+            auto body = actor->createComponent<RigidBodyComponent>();
+            body->setIsStatic(rec.bodyStatic != 0);
+            body->setBounciness(rec.bodyBounciness);
+            body->setRelativePos(toVec3(rec.bodyOffset));
+            if (rec.bodyKind == EBodyShapeBox) {
+                body->createBox(toVec3(rec.bodySize));
+            } else {
+                body->createSphere(rec.bodySize[0]);
+            }
+        }
+    }
+
+    float elapsedMs = std::chrono::duration<float, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    l->info(fmt::format("loaded {:d} actors from {:s} in {:.2f}ms", header.actorCount, path,
+                        elapsedMs));
+    return true;
+}
+
+}  // namespace luna
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "utils/common.hpp"
+
+// Binary scene (.lscn), actor hierarchy, transforms, component setup and asset references
+// saved from the live actor registry and loaded back from a memory mapped file without script
+//
+// file layout (native endian, every field 4 bytes):
+//   header : magic "LSCN", u32 version, u32 actor count, u32 string table bytes,
+//            clear color, sun direction, sun color (vec4 each)
+//   actors : SceneActorRecord[actor count], a parent always comes before its children
+//   strings: asset paths, referenced by offset and length from a record
+// not stored: tween and move components, actor state, camera yaw/pitch
+
+namespace luna {
+
+class Engine;
+
+constexpr uint32_t SCENE_FILE_MAGIC = 0x4E43534C;  // "LSCN"
+constexpr uint32_t SCENE_FILE_VERSION = 1;
+constexpr uint32_t SCENE_NO_PARENT = UINT32_MAX;
+
+enum SceneActorType { ESceneActorEmpty, ESceneActorStatic, ESceneActorCamera, ESceneActorLight };
+
+struct SceneFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t actorCount;
+        uint32_t stringBytes;
+        float clearColor[4];
+        float sunDir[4];
+        float sunColor[4];
+};
+
+// fixed size so the actor table is a plain array
+struct SceneActorRecord {
+        uint32_t type;    // SceneActorType
+        uint32_t parent;  // record index or SCENE_NO_PARENT
+        float position[3];
+        float rotation[4];  // x y z w
+        float scale;
+
+        // mesh component
+        uint32_t meshKind;  // MeshSourceKind
+        uint32_t meshPathOffset;
+        uint32_t meshPathLength;
+        float meshUpAxis[3];
+        float meshColor[3];
+        float meshSize;
+        int32_t meshHorizontalLine;
+        int32_t meshVerticalLine;
+
+        // rigid body component
+        uint32_t bodyKind;  // BodyShapeKind
+        uint32_t bodyStatic;
+        float bodySize[3];
+        float bodyOffset[3];
+        float bodyBounciness;
+
+        // light color and radius, or camera near, far, fov
+        float params[4];
+};
+
+static_assert(std::is_trivially_copyable_v<SceneFileHeader>);
+static_assert(std::is_trivially_copyable_v<SceneActorRecord>);
+
+class SceneFile {
+    public:
+        // every actor in the registry
+        static bool save(Engine &engine, const std::string &path);
+        // adds to the current scene
+        static bool load(const std::shared_ptr<Engine> &engine, const std::string &path);
+};
+
+}  // namespace luna
@@ -0,0 +1,35 @@
+#include "tick_list.hpp"
+
+namespace luna {
+
+void ActorTickList::clear() {
+    _handles.clear();
+    _slotToIdx.clear();
+    _pending.clear();
+}
+
+void ActorTickList::flush() {
+    for (const PendingOp& op : _pending) {
+        uint32_t slot = actorHandleIndex(op.handle);
+        if (slot >= _slotToIdx.size()) {
+            _slotToIdx.resize(slot + 1, NOT_LISTED);
+        }
+        uint32_t idx = _slotToIdx[slot];
+        bool listed = idx != NOT_LISTED && _handles[idx] == op.handle;
+        if (op.add) {
+            if (listed) continue;
+            _slotToIdx[slot] = static_cast<uint32_t>(_handles.size());
+            _handles.push_back(op.handle);
+        } else {
+            if (!listed) continue;
+            ActorHandle last = _handles.back();
+            _handles[idx] = last;
+            _slotToIdx[actorHandleIndex(last)] = idx;
+            _handles.pop_back();
+            _slotToIdx[slot] = NOT_LISTED;
+        }
+    }
+    _pending.clear();
+}
+
+}  // namespace luna
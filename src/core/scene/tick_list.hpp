@@ -0,0 +1,45 @@
+#pragma once
+
+#include "utils/common.hpp"
+#include "core/scene/actor_registry.hpp"
+
+// Opt-in list of actors that want a per frame call (update, input, preRender)
+// actor that never subscribes costs nothing, add/remove is deferred until the next walk so
+// an actor can (un)subscribe itself or others while the list is being iterated
+
+namespace luna {
+
+class ActorTickList {
+    public:
+        void add(ActorHandle handle) { _pending.push_back({handle, true}); }
+        void remove(ActorHandle handle) { _pending.push_back({handle, false}); }
+        void clear();
+
+        // fn(Actor*), stale handle is skipped
+        template <class Fn>
+        void forEach(const ActorRegistry& registry, const Fn& fn) {
+            flush();
+            for (size_t i = 0; i < _handles.size(); i++) {
+                Actor* actor = registry.get(_handles[i]);
+                if (actor != nullptr) fn(actor);
+            }
+        }
+
+        [[nodiscard]] size_t size() const { return _handles.size(); }
+
+    private:
+        static constexpr uint32_t NOT_LISTED = UINT32_MAX;
+
+        struct PendingOp {
+                ActorHandle handle;
+                bool add;
+        };
+
+        void flush();
+
+        std::vector<ActorHandle> _handles;
+        std::vector<uint32_t> _slotToIdx;  // by handle slot, for O(1) swap remove and dedup
+        std::vector<PendingOp> _pending;
+};
+
+}  // namespace luna
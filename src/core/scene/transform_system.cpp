@@ -0,0 +1,429 @@
+#include "transform_system.hpp"
+
+namespace luna {
+
+// in place along the cycles of _newToOld, which lists every node so it is a full permutation
+template <class T>
+void TransformSystem::permute(std::vector<T>& data) {
+    size_t count = _newToOld.size();
+    _permuted.assign(count, 0);
+    for (size_t start = 0; start < count; start++) {
+        if (_permuted[start]) continue;
+        T carried = std::move(data[start]);
+        size_t dst = start;
+        while (true) {
+            _permuted[dst] = 1;
+            size_t src = _newToOld[dst];
+            if (src == start) {
+                data[dst] = std::move(carried);
+                break;
+            }
+            data[dst] = std::move(data[src]);
+            dst = src;
+        }
+    }
+}
+
+void TransformSystem::add(ActorHandle handle) {
+    uint32_t slot = actorHandleIndex(handle);
+    if (slot >= _slotToNode.size()) {
+        _slotToNode.resize(slot + 1, NO_NODE);
+    }
+    // appended as root, order stays valid
+    _slotToNode[slot] = static_cast<uint32_t>(_handles.size());
+    _handles.push_back(handle);
+    _parents.push_back(NO_NODE);
+    _positions.emplace_back(0);
+    _rotations.push_back(glm::angleAxis(0.f, glm::vec3(0.f, 1.f, 0.f)));
+    _scales.push_back(1);
+    _prevPositions.push_back(_positions.back());
+    _prevRotations.push_back(_rotations.back());
+    _prevScales.push_back(1);
+    _locals.push_back(glm::identity<glm::mat4>());
+    _worlds.push_back(glm::identity<glm::mat4>());
+    _interpWorlds.push_back(glm::identity<glm::mat4>());
+    _localDirty.push_back(1);
+    _hasPrev.push_back(0);
+    _worldChanged.push_back(0);
+    _moved.push_back(0);
+    _interpChanged.push_back(0);
+}
+
+void TransformSystem::remove(ActorHandle handle) {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return;
+    // tombstone, children become roots on next update(), storage compacted lazily
+    _handles[node] = INVALID_ACTOR_HANDLE;
+    _slotToNode[actorHandleIndex(handle)] = NO_NODE;
+    _removedCount++;
+}
+
+void TransformSystem::clear() {
+    _slotToNode.clear();
+    _handles.clear();
+    _parents.clear();
+    _positions.clear();
+    _rotations.clear();
+    _scales.clear();
+    _prevPositions.clear();
+    _prevRotations.clear();
+    _prevScales.clear();
+    _locals.clear();
+    _worlds.clear();
+    _interpWorlds.clear();
+    _localDirty.clear();
+    _hasPrev.clear();
+    _worldChanged.clear();
+    _moved.clear();
+    _interpChanged.clear();
+    _orderDirty = false;
+    _removedCount = 0;
+}
+
+void TransformSystem::reserve(size_t count) {
+    _slotToNode.reserve(count);
+    _handles.reserve(count);
+    _parents.reserve(count);
+    _positions.reserve(count);
+    _rotations.reserve(count);
+    _scales.reserve(count);
+    _prevPositions.reserve(count);
+    _prevRotations.reserve(count);
+    _prevScales.reserve(count);
+    _locals.reserve(count);
+    _worlds.reserve(count);
+    _interpWorlds.reserve(count);
+    _localDirty.reserve(count);
+    _hasPrev.reserve(count);
+    _worldChanged.reserve(count);
+    _moved.reserve(count);
+    _interpChanged.reserve(count);
+}
+
+bool TransformSystem::setParent(ActorHandle child, ActorHandle parent) {
+    uint32_t childNode = nodeOf(child);
+    if (childNode == NO_NODE) return false;
+    uint32_t parentNode = NO_NODE;
+    if (parent != INVALID_ACTOR_HANDLE) {
+        parentNode = nodeOf(parent);
+        if (parentNode == NO_NODE) return false;
+        for (uint32_t p = parentNode; p != NO_NODE; p = _parents[p]) {
+            if (p == childNode) {
+                auto l = SLog::get();
+                l->error(fmt::format("set parent {:#x} on {:#x} creates a cycle", parent, child));
+                return false;
+            }
+        }
+    }
+
+    _parents[childNode] = parentNode;
+    if (parentNode != NO_NODE && parentNode > childNode) {
+        _orderDirty = true;
+    }
+    // local is now relative to another space, don't blend across it
+    _prevPositions[childNode] = _positions[childNode];
+    _prevRotations[childNode] = _rotations[childNode];
+    _prevScales[childNode] = _scales[childNode];
+    markMoved(childNode);
+    return true;
+}
+
+void TransformSystem::setLocalPosition(ActorHandle handle, const glm::vec3& pos) {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return;
+    _positions[node] = pos;
+    markMoved(node);
+}
+
+void TransformSystem::setLocalRotation(ActorHandle handle, const glm::quat& rot) {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return;
+    _rotations[node] = rot;
+    markMoved(node);
+}
+
+void TransformSystem::setLocalScale(ActorHandle handle, float scale) {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return;
+    _scales[node] = scale;
+    markMoved(node);
+}
+
+void TransformSystem::setWorldPosition(ActorHandle handle, const glm::vec3& pos) {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return;
+    uint32_t parentNode = _parents[node];
+    if (parentNode == NO_NODE || _handles[parentNode] == INVALID_ACTOR_HANDLE) {
+        _positions[node] = pos;
+    } else {
+        glm::mat4 parentWorld = getWorldTransform(_handles[parentNode]);
+        _positions[node] = glm::vec3(glm::inverse(parentWorld) * glm::vec4(pos, 1));
+    }
+    markMoved(node);
+}
+
+glm::vec3 TransformSystem::getLocalPosition(ActorHandle handle) const {
+    uint32_t node = nodeOf(handle);
+    return node == NO_NODE ? glm::vec3{0} : _positions[node];
+}
+
+glm::quat TransformSystem::getLocalRotation(ActorHandle handle) const {
+    uint32_t node = nodeOf(handle);
+    return node == NO_NODE ? glm::identity<glm::quat>() : _rotations[node];
+}
+
+float TransformSystem::getLocalScale(ActorHandle handle) const {
+    uint32_t node = nodeOf(handle);
+    return node == NO_NODE ? 1.f : _scales[node];
+}
+
+glm::mat4 TransformSystem::getLocalTransform(ActorHandle handle) const {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return glm::identity<glm::mat4>();
+    return _localDirty[node] ? composeLocal(node) : _locals[node];
+}
+
+glm::mat4 TransformSystem::getWorldTransform(ActorHandle handle) const {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return glm::identity<glm::mat4>();
+
+    // a removed parent ends the chain, same as the root promotion in update()
+    auto parentOf = [this](uint32_t n) {
+        uint32_t p = _parents[n];
+        return (p != NO_NODE && _handles[p] == INVALID_ACTOR_HANDLE) ? NO_NODE : p;
+    };
+
+    // cached world is valid only when no node up the chain changed since last update()
+    // find the top most dirty ancestor and rebuild from there, chain is short in practice
+    uint32_t topDirty = NO_NODE;
+    for (uint32_t n = node; n != NO_NODE; n = parentOf(n)) {
+        if (_localDirty[n] || parentOf(n) != _parents[n]) topDirty = n;
+    }
+    if (topDirty == NO_NODE) return _worlds[node];
+
+    glm::mat4 world = composeLocal(node);
+    uint32_t stop = parentOf(topDirty);
+    for (uint32_t n = parentOf(node); n != NO_NODE; n = parentOf(n)) {
+        if (n == stop) {
+            return _worlds[n] * world;
+        }
+        world = composeLocal(n) * world;
+    }
+    return world;
+}
+
+void TransformSystem::savePreviousTransforms() {
+    // node that didn't move already has previous == current
+    size_t count = _handles.size();
+    for (size_t i = 0; i < count; i++) {
+        if (!_moved[i] && _hasPrev[i]) continue;
+        _prevPositions[i] = _positions[i];
+        _prevRotations[i] = _rotations[i];
+        _prevScales[i] = _scales[i];
+        _moved[i] = 0;
+        _hasPrev[i] = 1;
+    }
+}
+
+glm::vec3 TransformSystem::getInterpolatedLocalPosition(ActorHandle handle, float alpha) const {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return glm::vec3{0};
+    return glm::mix(_prevPositions[node], _positions[node], alpha);
+}
+
+glm::quat TransformSystem::getInterpolatedLocalRotation(ActorHandle handle, float alpha) const {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return glm::identity<glm::quat>();
+    return glm::slerp(_prevRotations[node], _rotations[node], alpha);
+}
+
+glm::mat4 TransformSystem::getInterpolatedWorldTransform(ActorHandle handle) const {
+    uint32_t node = nodeOf(handle);
+    if (node == NO_NODE) return glm::identity<glm::mat4>();
+    return _interpChanged[node] ? _interpWorlds[node] : _worlds[node];
+}
+
+void TransformSystem::update() {
+    if (_orderDirty || _removedCount > _handles.size() / COMPACT_DIVISOR) {
+        rebuildOrder();
+    }
+
+    // parent is always before child, so parent world is final when we reach the child
+    size_t count = _handles.size();
+    for (size_t i = 0; i < count; i++) {
+        if (_handles[i] == INVALID_ACTOR_HANDLE) {
+            _worldChanged[i] = 0;
+            continue;
+        }
+        uint32_t parentNode = _parents[i];
+        if (parentNode != NO_NODE && _handles[parentNode] == INVALID_ACTOR_HANDLE) {
+            // parent removed, promote to root, a root keeps the order valid wherever it sits
+            _parents[i] = NO_NODE;
+            parentNode = NO_NODE;
+            markMoved(i);
+        }
+        bool parentChanged = parentNode != NO_NODE && _worldChanged[parentNode];
+        if (!_localDirty[i] && !parentChanged) {
+            _worldChanged[i] = 0;
+            continue;
+        }
+        if (_localDirty[i]) {
+            _locals[i] = composeLocal(i);
+            _localDirty[i] = 0;
+        }
+        _worlds[i] = parentNode == NO_NODE ? _locals[i] : _worlds[parentNode] * _locals[i];
+        _worldChanged[i] = 1;
+    }
+}
+
+void TransformSystem::interpolate(float alpha) {
+    _changedHandles.clear();
+    size_t count = _handles.size();
+    for (size_t i = 0; i < count; i++) {
+        if (_handles[i] == INVALID_ACTOR_HANDLE) {
+            _interpChanged[i] = 0;
+            continue;
+        }
+        uint32_t parentNode = _parents[i];
+        bool parentChanged = parentNode != NO_NODE && _interpChanged[parentNode];
+        if (!_moved[i] && !parentChanged) {
+            // settled this frame (last blend differs from world) or world itself changed
+            if (_interpChanged[i] || _worldChanged[i]) _changedHandles.push_back(_handles[i]);
+            _interpChanged[i] = 0;
+            continue;
+        }
+        _changedHandles.push_back(_handles[i]);
+        glm::mat4 local = composeInterpolatedLocal(i, alpha);
+        if (parentNode == NO_NODE) {
+            _interpWorlds[i] = local;
+        } else {
+            const glm::mat4& parentWorld =
+                _interpChanged[parentNode] ? _interpWorlds[parentNode] : _worlds[parentNode];
+            _interpWorlds[i] = parentWorld * local;
+        }
+        _interpChanged[i] = 1;
+    }
+}
+
+glm::mat4 TransformSystem::composeLocal(uint32_t node) const {
+    // Scale, then rotate, then translate
+    return glm::translate(glm::identity<glm::mat4>(), _positions[node]) *
+           glm::mat4_cast(_rotations[node]) *
+           glm::scale(glm::identity<glm::mat4>(), glm::vec3{_scales[node]});
+}
+
+glm::mat4 TransformSystem::composeInterpolatedLocal(uint32_t node, float alpha) const {
+    glm::vec3 pos = glm::mix(_prevPositions[node], _positions[node], alpha);
+    glm::quat rot = glm::slerp(_prevRotations[node], _rotations[node], alpha);
+    float scale = glm::mix(_prevScales[node], _scales[node], alpha);
+    return glm::translate(glm::identity<glm::mat4>(), pos) * glm::mat4_cast(rot) *
+           glm::scale(glm::identity<glm::mat4>(), glm::vec3{scale});
+}
+
+void TransformSystem::markMoved(uint32_t node) {
+    if (!_hasPrev[node]) {
+        // newly spawned, nothing to blend from
+        _prevPositions[node] = _positions[node];
+        _prevRotations[node] = _rotations[node];
+        _prevScales[node] = _scales[node];
+    }
+    _localDirty[node] = 1;
+    _moved[node] = 1;
+}
+
+void TransformSystem::rebuildOrder() {
+    _orderDirty = false;
+    size_t count = _handles.size();
+
+    // children list in compact form (offset + count per node)
+    _childStart.assign(count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        if (_handles[i] == INVALID_ACTOR_HANDLE) continue;
+        uint32_t p = _parents[i];
+        if (p != NO_NODE && _handles[p] == INVALID_ACTOR_HANDLE) {
+            // parent removed, promote to root, world space no longer includes it
+            _parents[i] = NO_NODE;
+            markMoved(i);
+            p = NO_NODE;
+        }
+        if (p != NO_NODE) _childStart[p + 1]++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        _childStart[i + 1] += _childStart[i];
+    }
+    _children.resize(_childStart[count]);
+    _childFill.assign(_childStart.begin(), _childStart.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        if (_handles[i] == INVALID_ACTOR_HANDLE || _parents[i] == NO_NODE) continue;
+        _children[_childFill[_parents[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // depth first from each root, keep subtree contiguous
+    _newToOld.clear();
+    _stack.clear();
+    for (size_t root = 0; root < count; root++) {
+        if (_handles[root] == INVALID_ACTOR_HANDLE || _parents[root] != NO_NODE) continue;
+        _stack.push_back(static_cast<uint32_t>(root));
+        while (!_stack.empty()) {
+            uint32_t n = _stack.back();
+            _stack.pop_back();
+            _newToOld.push_back(n);
+            // push in reverse so children keep their relative order
+            for (uint32_t c = _childStart[n + 1]; c > _childStart[n]; c--) {
+                _stack.push_back(_children[c - 1]);
+            }
+        }
+    }
+    // tombstones go to the tail and are dropped after permuting
+    size_t liveCount = _newToOld.size();
+    for (size_t i = 0; i < count; i++) {
+        if (_handles[i] == INVALID_ACTOR_HANDLE) _newToOld.push_back(static_cast<uint32_t>(i));
+    }
+
+    _oldToNew.assign(count, NO_NODE);
+    for (uint32_t i = 0; i < liveCount; i++) {
+        _oldToNew[_newToOld[i]] = i;
+    }
+
+    permute(_handles);
+    permute(_parents);
+    permute(_positions);
+    permute(_rotations);
+    permute(_scales);
+    permute(_prevPositions);
+    permute(_prevRotations);
+    permute(_prevScales);
+    permute(_locals);
+    permute(_worlds);
+    permute(_interpWorlds);
+    permute(_localDirty);
+    permute(_hasPrev);
+    permute(_worldChanged);
+    permute(_moved);
+    permute(_interpChanged);
+
+    _handles.resize(liveCount);
+    _parents.resize(liveCount);
+    _positions.resize(liveCount);
+    _rotations.resize(liveCount);
+    _scales.resize(liveCount);
+    _prevPositions.resize(liveCount);
+    _prevRotations.resize(liveCount);
+    _prevScales.resize(liveCount);
+    _locals.resize(liveCount);
+    _worlds.resize(liveCount);
+    _interpWorlds.resize(liveCount);
+    _localDirty.resize(liveCount);
+    _hasPrev.resize(liveCount);
+    _worldChanged.resize(liveCount);
+    _moved.resize(liveCount);
+    _interpChanged.resize(liveCount);
+    _removedCount = 0;
+
+    for (uint32_t i = 0; i < liveCount; i++) {
+        if (_parents[i] != NO_NODE) _parents[i] = _oldToNew[_parents[i]];
+        _slotToNode[actorHandleIndex(_handles[i])] = i;
+    }
+}
+
+}  // namespace luna
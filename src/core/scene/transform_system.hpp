@@ -0,0 +1,106 @@
+#pragma once
+
+#include "utils/common.hpp"
+#include "core/scene/actor_registry.hpp"
+
+// Actor transforms in structure of arrays, sorted so parent always comes before its children
+// one linear pass recomputes only dirty subtrees, hierarchy change triggers a re-sort
+// removal leaves a tombstone, compacted by the re-sort once enough of them pile up
+// world getter is exact at any time by walking up the (index based) parent chain when dirty
+
+namespace luna {
+
+class TransformSystem {
+    public:
+        void add(ActorHandle handle);
+        void remove(ActorHandle handle);
+        void clear();
+        // capacity kept across clear, bulk spawn grows storage once
+        void reserve(size_t count);
+
+        // invalid parent detaches, rejects cycle
+        bool setParent(ActorHandle child, ActorHandle parent);
+
+        // local space setter / getter
+        void setLocalPosition(ActorHandle handle, const glm::vec3& pos);
+        void setLocalRotation(ActorHandle handle, const glm::quat& rot);
+        void setLocalScale(ActorHandle handle, float scale);
+        void setWorldPosition(ActorHandle handle, const glm::vec3& pos);
+        [[nodiscard]] glm::vec3 getLocalPosition(ActorHandle handle) const;
+        [[nodiscard]] glm::quat getLocalRotation(ActorHandle handle) const;
+        [[nodiscard]] float getLocalScale(ActorHandle handle) const;
+        [[nodiscard]] glm::mat4 getLocalTransform(ActorHandle handle) const;
+        [[nodiscard]] glm::mat4 getWorldTransform(ActorHandle handle) const;
+
+        // fixed step interpolation, snapshot before each step, blend once per rendered frame
+        void savePreviousTransforms();
+        [[nodiscard]] glm::vec3 getInterpolatedLocalPosition(ActorHandle handle, float alpha) const;
+        [[nodiscard]] glm::quat getInterpolatedLocalRotation(ActorHandle handle, float alpha) const;
+        // valid after interpolate()
+        [[nodiscard]] glm::mat4 getInterpolatedWorldTransform(ActorHandle handle) const;
+
+        // resolve hierarchy change and recompute world of dirty subtrees
+        void update();
+        // blend world transform of moving subtrees, call after update()
+        void interpolate(float alpha);
+
+        // handles whose interpolated world transform changed in the last interpolate()
+        [[nodiscard]] const std::vector<ActorHandle>& getChangedHandles() const {
+            return _changedHandles;
+        }
+        [[nodiscard]] size_t size() const { return _handles.size() - _removedCount; }
+
+    private:
+        static constexpr uint32_t NO_NODE = UINT32_MAX;
+        // tombstone share of all nodes that triggers compaction
+        static constexpr uint32_t COMPACT_DIVISOR = 4;
+
+        [[nodiscard]] uint32_t nodeOf(ActorHandle handle) const {
+            uint32_t slot = actorHandleIndex(handle);
+            if (slot >= _slotToNode.size()) return NO_NODE;
+            uint32_t node = _slotToNode[slot];
+            return (node != NO_NODE && _handles[node] == handle) ? node : NO_NODE;
+        }
+        [[nodiscard]] glm::mat4 composeLocal(uint32_t node) const;
+        [[nodiscard]] glm::mat4 composeInterpolatedLocal(uint32_t node, float alpha) const;
+        void markMoved(uint32_t node);
+        void rebuildOrder();
+        template <class T>
+        void permute(std::vector<T>& data);
+
+        // sparse, indexed by actor handle slot
+        std::vector<uint32_t> _slotToNode;
+
+        // dense, indexed by node
+        std::vector<ActorHandle> _handles;  // INVALID_ACTOR_HANDLE marks a removed node
+        std::vector<uint32_t> _parents;
+        std::vector<glm::vec3> _positions;
+        std::vector<glm::quat> _rotations;
+        std::vector<float> _scales;
+        std::vector<glm::vec3> _prevPositions;
+        std::vector<glm::quat> _prevRotations;
+        std::vector<float> _prevScales;
+        std::vector<glm::mat4> _locals;
+        std::vector<glm::mat4> _worlds;
+        std::vector<glm::mat4> _interpWorlds;
+        std::vector<uint8_t> _localDirty;     // local changed since last update()
+        std::vector<uint8_t> _hasPrev;        // false until first snapshot, spawn doesn't blend
+        std::vector<uint8_t> _worldChanged;   // scratch for update()
+        std::vector<uint8_t> _moved;          // local changed since last savePreviousTransforms()
+        std::vector<uint8_t> _interpChanged;  // interp world differs from world
+
+        std::vector<ActorHandle> _changedHandles;
+        bool _orderDirty = false;
+        uint32_t _removedCount = 0;  // tombstones waiting for compaction
+
+        // rebuildOrder() scratch, kept to avoid allocating on every re-sort
+        std::vector<uint32_t> _childStart;
+        std::vector<uint32_t> _children;
+        std::vector<uint32_t> _childFill;
+        std::vector<uint32_t> _stack;
+        std::vector<uint32_t> _newToOld;
+        std::vector<uint32_t> _oldToNew;
+        std::vector<uint8_t> _permuted;
+};
+
+}  // namespace luna
@@ -0,0 +1,21 @@
+#include <algorithm>
+
+#include "update_tier.hpp"
+
+namespace luna {
+
+UpdateTier selectUpdateTier(float distance, bool visible, const UpdateTierConfig& config) {
+    if (distance < config.fullRateDist) return ETierEveryStep;
+
+    int tier = ETierEvery8;
+    if (distance < config.halfRateDist) {
+        tier = ETierEvery2;
+    } else if (distance < config.quarterRateDist) {
+        tier = ETierEvery4;
+    }
+    // nobody sees it change, drop one more tier
+    if (!visible) tier = std::min(tier + 1, static_cast<int>(ETierEvery8));
+    return static_cast<UpdateTier>(tier);
+}
+
+}  // namespace luna
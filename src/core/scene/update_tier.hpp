@@ -0,0 +1,42 @@
+#pragma once
+
+#include "utils/common.hpp"
+
+// Update rate tiers, far or offscreen actors update every 2nd/4th/8th simulation step with the
+// delta time accumulated since their last run, phase is spread by handle so a tier's actors
+// don't all land on the same step
+
+namespace luna {
+
+enum UpdateTier { ETierEveryStep = 0, ETierEvery2, ETierEvery4, ETierEvery8, ETierCount };
+
+struct UpdateTierConfig {
+        float fullRateDist = 20.0f;    // closer than this always runs every step
+        float halfRateDist = 40.0f;
+        float quarterRateDist = 80.0f;  // beyond this every 8th step
+        float offscreenMargin = 0.1f;  // ndc margin so actors at screen edge count as visible
+        int actorsPerFrame = 2048;     // tier re-evaluation budget, round robin over actors
+};
+
+struct UpdateTierState {
+        uint8_t interval = 1;  // power of two
+        uint8_t phase = 0;
+        float accumS = 0;
+
+        void set(UpdateTier tier, uint32_t spreadKey) {
+            interval = static_cast<uint8_t>(1u << tier);
+            phase = static_cast<uint8_t>(spreadKey & (interval - 1));
+        }
+        // accumulate and return true with the summed delta when this step should run
+        bool advance(uint64_t step, float deltaTime, float& outDeltaTime) {
+            accumS += deltaTime;
+            if (((step + phase) & (interval - 1)) != 0) return false;
+            outDeltaTime = accumS;
+            accumS = 0;
+            return true;
+        }
+};
+
+UpdateTier selectUpdateTier(float distance, bool visible, const UpdateTierConfig& config);
+
+}  // namespace luna
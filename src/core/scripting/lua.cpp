@@ -2,6 +2,7 @@
 #include "lua.hpp"
 #include "core/physic/physic.hpp"
 #include "core/renderer/renderer.hpp"
+#include "core/time/frame_pacer.hpp"
 #include "actors/actor.hpp"
 #include "actors/player/camera.hpp"
 #include "actors/object/point_light.hpp"
@@ -11,10 +12,36 @@
 #include "components/graphic/mesh.hpp"
 #include "components/physic/rigidbody.hpp"
 #include "components/anim/tween.hpp"
+#include "core/scene/prefab.hpp"
+#include "core/scene/scene_file.hpp"
 
 constexpr const char *SCRIPT_MODULE_PATH = "assets.scene.demo";
 
 namespace luna {
+namespace {
+
+// a proxy outlives its actor while script holds the component, skip those and duplicates
+std::vector<ActorHandle> uniqueLiveActors(Engine &engine, std::vector<ActorHandle> &handles) {
+    std::sort(handles.begin(), handles.end());
+    handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+    const ActorRegistry &registry = engine.getActorRegistry();
+    std::erase_if(handles, [&registry](ActorHandle h) { return !registry.isValid(h); });
+    return handles;
+}
+
+// component creation from script, actor handle may be stale if the actor was already removed
+template <class T>
+std::shared_ptr<T> newComponent(const std::shared_ptr<Engine> &engine, ActorHandle actorId) {
+    auto actor = engine->getActor(actorId);
+    if (actor == nullptr) {
+        auto l = SLog::get();
+        l->error(fmt::format("cannot add component, stale actor handle {:#x}", actorId));
+        return nullptr;
+    }
+    return actor->createComponent<T>();
+}
+}  // namespace
+
 bool ScriptingSystem::initialise(const std::shared_ptr<Engine> &engine) {
     _engine = engine;
     _globState.open_libraries();
@@ -60,6 +87,56 @@ void ScriptingSystem::registerLuna() {
         _engine->getRenderer()->setDirLight(glm::normalize(dir), color);
     });
 
+    // engine functions
+    lunaNs.set_function("SetTargetFps",
+                        [this](int fps) { _engine->getFramePacer()->setTargetFps(fps); });
+    lunaNs.set_function("SetSimulationRate", [this](int hz) { _engine->setSimulationRate(hz); });
+    lunaNs.set_function("ReserveActors",
+                        [this](int count) { _engine->reserveActors(std::max(0, count)); });
+    // binary scene, load appends to the current scene
+    lunaNs.set_function("SaveScene", [this](const std::string &path) {
+        return SceneFile::save(*_engine, path);
+    });
+    lunaNs.set_function("LoadScene", [this](const std::string &path) {
+        return SceneFile::load(_engine, path);
+    });
+
+    // spatial queries against mesh and light bounds, return actor handles
+    lunaNs.set_function("QuerySphere", [this](const glm::vec3 &center, float radius) {
+        std::vector<ActorHandle> found;
+        const DynamicBvh &spatial = _engine->getSpatialIndex();
+        spatial.querySphere(center, radius, ESpatialAll, [&](int32_t proxy) {
+            found.push_back(spatial.getOwner(proxy));
+            return true;
+        });
+        return uniqueLiveActors(*_engine, found);
+    });
+    lunaNs.set_function("QueryBox", [this](const glm::vec3 &min, const glm::vec3 &max) {
+        std::vector<ActorHandle> found;
+        const DynamicBvh &spatial = _engine->getSpatialIndex();
+        spatial.queryAabb({min, max}, ESpatialAll, [&](int32_t proxy) {
+            found.push_back(spatial.getOwner(proxy));
+            return true;
+        });
+        return uniqueLiveActors(*_engine, found);
+    });
+    // closest mesh bounds hit, returns handle (0 on miss) and distance
+    lunaNs.set_function("RayCast", [this](const glm::vec3 &origin, const glm::vec3 &dir,
+                                          float maxDist) {
+        ActorHandle hit = INVALID_ACTOR_HANDLE;
+        float hitDist = maxDist;
+        const DynamicBvh &spatial = _engine->getSpatialIndex();
+        spatial.rayCast(origin, glm::normalize(dir), maxDist, ESpatialMesh,
+                        [&](int32_t proxy, float dist) {
+                            if (dist < hitDist || hit == INVALID_ACTOR_HANDLE) {
+                                hit = spatial.getOwner(proxy);
+                                hitDist = dist;
+                            }
+                            return hitDist;
+                        });
+        return std::make_tuple(hit, hitDist);
+    });
+
     // base actor
     auto luaActor = lunaNs.new_usertype<Actor>("Actor");
     luaActor["setLocalPosition"] = &Actor::setLocalPosition;
@@ -67,31 +144,35 @@ void ScriptingSystem::registerLuna() {
     luaActor["setRotation"] = &Actor::setRotation;
     luaActor["setScale"] = &Actor::setScale;
     luaActor["getId"] = &Actor::getId;
+    luaActor["setAutoUpdateTier"] = &Actor::setAutoUpdateTier;
+    luaActor["setUpdateTier"] = [](Actor &actor, int tier) {
+        actor.setUpdateTier(static_cast<UpdateTier>(std::clamp(tier, 0, ETierCount - 1)));
+    };
 
     // inherit actor
     lunaNs.new_usertype<EmptyActor>("EmptyActor", sol::base_classes, sol::bases<Actor>());
-    lunaNs.set_function("NewEmptyActor", [this]() {
-        auto a = std::make_shared<EmptyActor>();
-        _engine->addActor(a);
-        return a;
-    });
+    lunaNs.set_function("NewEmptyActor", [this]() { return _engine->createActor<EmptyActor>(); });
     lunaNs.new_usertype<CameraActor>("CameraActor", sol::base_classes, sol::bases<Actor>());
-    lunaNs.set_function("NewCameraActor", [this]() {
-        auto a = std::make_shared<CameraActor>();
-        _engine->addActor(a);
-        return a;
-    });
+    lunaNs.set_function("NewCameraActor", [this]() { return _engine->createActor<CameraActor>(); });
     lunaNs.new_usertype<StaticActor>("StaticActor", sol::base_classes, sol::bases<Actor>());
     lunaNs.set_function("NewStaticActor", [this](const std::string &modelPath) {
-        auto a = std::make_shared<StaticActor>(modelPath);
-        _engine->addActor(a);
-        return a;
+        return _engine->createActor<StaticActor>(modelPath);
     });
     lunaNs.new_usertype<PointLightActor>("PointLightActor", sol::base_classes, sol::bases<Actor>());
     lunaNs.set_function("NewPointLightActor", [this](const glm::vec3 &color, float radius) {
-        auto a = std::make_shared<PointLightActor>(color, 0.3, radius);
-        _engine->addActor(a);
-        return a;
+        return _engine->createActor<PointLightActor>(color, 0.3, radius);
+    });
+
+    // prefab, owned by script, instances are owned by engine
+    lunaNs.new_usertype<Prefab>(
+        "Prefab", sol::constructors<Prefab(), Prefab(std::string)>(), "setModel",
+        sol::overload([](Prefab &prefab, const std::string &path) { prefab.setModel(path); },
+                      &Prefab::setModel),
+        "setSquarePlane", &Prefab::setSquarePlane, "setSphere", &Prefab::setSphere, "setScale",
+        &Prefab::setScale, "setBoxBody", &Prefab::setBoxBody, "setSphereBody",
+        &Prefab::setSphereBody, "getInstanceCount", &Prefab::getInstanceCount);
+    lunaNs.set_function("InstantiatePrefab", [this](Prefab &prefab, const glm::vec3 &pos) {
+        return prefab.instantiate(_engine, pos);
     });
 
     // base components
@@ -103,10 +184,8 @@ void ScriptingSystem::registerLuna() {
         "MeshComponent", sol::base_classes, sol::bases<Component>(), "generateSquarePlane",
         &MeshComponent::generateSquarePlane, "generateSphere", &MeshComponent::generateSphere,
         "loadModal", &MeshComponent::loadModal, "uploadToGpu", &MeshComponent::uploadToGpu);
-    lunaNs.set_function("NewMeshComponent", [this](int actorId) {
-        auto c = std::make_shared<MeshComponent>(_engine, actorId);
-        _engine->getActor(actorId)->addComponent(c);
-        return c;
+    lunaNs.set_function("NewMeshComponent", [this](ActorHandle actorId) {
+        return newComponent<MeshComponent>(_engine, actorId);
     });
 
     lunaNs.new_usertype<RigidBodyComponent>(
@@ -115,20 +194,16 @@ void ScriptingSystem::registerLuna() {
         "createBox", &RigidBodyComponent::createBox, "createSphere",
         &RigidBodyComponent::createSphere, "setLinearVelocity",
         &RigidBodyComponent::setLinearVelocity);
-    lunaNs.set_function("NewRigidBodyComponent", [this](int actorId) {
-        auto c = std::make_shared<RigidBodyComponent>(_engine, actorId);
-        _engine->getActor(actorId)->addComponent(c);
-        return c;
+    lunaNs.set_function("NewRigidBodyComponent", [this](ActorHandle actorId) {
+        return newComponent<RigidBodyComponent>(_engine, actorId);
     });
 
     lunaNs.new_usertype<TweenComponent>(
         "TweenComponent", sol::base_classes, sol::bases<Component>(), "addTranslateOffset",
         &TweenComponent::addTranslateOffset, "addRotationOffset",
         &TweenComponent::addRotationOffset, "setLoopType", &TweenComponent::setLoopType);
-    lunaNs.set_function("NewTweenComponent", [this](int actorId) {
-        auto c = std::make_shared<TweenComponent>(_engine, actorId);
-        _engine->getActor(actorId)->addComponent(c);
-        return c;
+    lunaNs.set_function("NewTweenComponent", [this](ActorHandle actorId) {
+        return newComponent<TweenComponent>(_engine, actorId);
     });
 }
 
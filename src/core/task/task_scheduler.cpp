@@ -0,0 +1,195 @@
+#include <algorithm>
+
+#include "task_scheduler.hpp"
+#include "core/profile/profiler.hpp"
+
+namespace luna {
+
+// identify which worker (if any) current thread belongs to
+static thread_local TaskScheduler *tScheduler = nullptr;
+static thread_local int tWorkerIdx = -1;
+
+bool TaskScheduler::initialise(int workerCount) {
+    auto l = SLog::get();
+    if (workerCount <= 0) {
+        // leave room for game and render thread
+        workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 2);
+    }
+
+    _stop = false;
+    for (int i = 0; i < workerCount; ++i) {
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(&TaskScheduler::workerMain, this, i);
+    }
+
+    l->info(fmt::format("task scheduler started with {:d} workers", workerCount));
+    return true;
+}
+
+void TaskScheduler::shutdown() {
+    {
+        std::lock_guard lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCv.notify_all();
+    for (auto &worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+    _queues.clear();
+}
+
+bool TaskScheduler::isWorkerThread() const { return tScheduler == this && tWorkerIdx >= 0; }
+
+void TaskScheduler::submit(TaskFn task, TaskGroup *group) {
+    if (group) group->_pending.fetch_add(1, std::memory_order_relaxed);
+
+    // worker pushes to its own queue, other threads spread the work round robin
+    int queueIdx = isWorkerThread()
+                       ? tWorkerIdx
+                       : static_cast<int>(_nextExternalQueue.fetch_add(1) % _queues.size());
+    {
+        std::lock_guard lock(_queues[queueIdx]->mutex);
+        _queues[queueIdx]->tasks.push_back({std::move(task), group});
+    }
+    _queuedCount.fetch_add(1, std::memory_order_release);
+
+    // lock to not miss a worker that is just about to sleep
+    { std::lock_guard lock(_sleepMutex); }
+    _sleepCv.notify_one();
+}
+
+void TaskScheduler::wait(TaskGroup &group) {
+    int selfIdx = isWorkerThread() ? tWorkerIdx : -1;
+    while (!group.isDone()) {
+        if (!tryRunOne(selfIdx)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::parallelFor(int count, int grainSize,
+                                const std::function<void(int, int)> &fn) {
+    if (count <= 0) return;
+    grainSize = std::max(1, grainSize);
+    if (count <= grainSize || _workers.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    TaskGroup group;
+    // keep the first chunk for the calling thread
+    for (int begin = grainSize; begin < count; begin += grainSize) {
+        int end = std::min(count, begin + grainSize);
+        submit([&fn, begin, end]() { fn(begin, end); }, &group);
+    }
+    fn(0, grainSize);
+    wait(group);
+}
+
+void TaskScheduler::workerMain(int workerIdx) {
+    tScheduler = this;
+    tWorkerIdx = workerIdx;
+    Profiler::get()->setThreadName(fmt::format("Worker {:d}", workerIdx));
+
+    while (true) {
+        if (tryRunOne(workerIdx)) continue;
+
+        std::unique_lock lock(_sleepMutex);
+        _sleepCv.wait(lock, [this]() {
+            return _stop.load() || _queuedCount.load(std::memory_order_acquire) > 0;
+        });
+        if (_stop) break;
+    }
+
+    tScheduler = nullptr;
+    tWorkerIdx = -1;
+}
+
+bool TaskScheduler::tryRunOne(int workerIdx) {
+    Task task;
+    if ((workerIdx >= 0 && popLocal(workerIdx, task)) || steal(workerIdx, task)) {
+        execute(task);
+        return true;
+    }
+    return false;
+}
+
+bool TaskScheduler::popLocal(int workerIdx, Task &outTask) {
+    WorkerQueue &queue = *_queues[workerIdx];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    outTask = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    _queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool TaskScheduler::steal(int thiefIdx, Task &outTask) {
+    // start from the neighbour so thieves don't all hammer queue 0
+    const int queueCount = static_cast<int>(_queues.size());
+    const int start = thiefIdx >= 0 ? thiefIdx + 1 : 0;
+    for (int i = 0; i < queueCount; ++i) {
+        int victimIdx = (start + i) % queueCount;
+        if (victimIdx == thiefIdx) continue;
+
+        WorkerQueue &queue = *_queues[victimIdx];
+        std::unique_lock lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.tasks.empty()) continue;
+        outTask = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        _queuedCount.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::execute(Task &task) {
+    task.fn();
+    if (task.group) task.group->_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+int TaskGraph::addTask(TaskFn task) {
+    auto node = std::make_unique<Node>();
+    node->fn = std::move(task);
+    _nodes.push_back(std::move(node));
+    return static_cast<int>(_nodes.size()) - 1;
+}
+
+void TaskGraph::addDependency(int beforeId, int afterId) {
+    _nodes[beforeId]->successors.push_back(afterId);
+    _nodes[afterId]->dependencyCount++;
+}
+
+void TaskGraph::run(TaskScheduler &scheduler) {
+    for (auto &node : _nodes) {
+        node->remaining.store(node->dependencyCount, std::memory_order_relaxed);
+    }
+
+    TaskGroup group;
+    for (int i = 0; i < _nodes.size(); ++i) {
+        if (_nodes[i]->dependencyCount == 0) {
+            submitNode(scheduler, group, i);
+        }
+    }
+    scheduler.wait(group);
+}
+
+void TaskGraph::submitNode(TaskScheduler &scheduler, TaskGroup &group, int nodeId) {
+    scheduler.submit(
+        [this, &scheduler, &group, nodeId]() {
+            Node &node = *_nodes[nodeId];
+            node.fn();
+            // successors join the group before this task leaves it, wait never ends early
+            for (int successorId : node.successors) {
+                if (_nodes[successorId]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    submitNode(scheduler, group, successorId);
+                }
+            }
+        },
+        &group);
+}
+
+}  // namespace luna
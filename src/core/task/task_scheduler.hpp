@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "utils/common.hpp"
+
+// Engine wide work stealing scheduler, every subsystem that wants parallelism (physic, actor
+// update, asset loading, culling) should go through it instead of spawning its own threads
+// each worker owns a deque, owner pops from the back (lifo, cache friendly) and idle workers
+// steal from the front of other deques
+
+namespace luna {
+
+using TaskFn = std::function<void()>;
+
+// counts outstanding tasks, used to wait for a batch of submitted work
+class TaskGroup {
+    public:
+        [[nodiscard]] bool isDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class TaskScheduler;
+        std::atomic<int> _pending{0};
+};
+
+class TaskScheduler {
+    public:
+        // workerCount <= 0 picks hardware concurrency minus game and render thread
+        bool initialise(int workerCount = 0);
+        void shutdown();
+
+        void submit(TaskFn task, TaskGroup *group = nullptr);
+        // block until every task in the group finished, calling thread runs queued tasks meanwhile
+        void wait(TaskGroup &group);
+        // split [0, count) into chunks of at most grainSize and run fn(begin, end) on each
+        void parallelFor(int count, int grainSize, const std::function<void(int, int)> &fn);
+
+        // getter
+        [[nodiscard]] int getWorkerCount() const { return static_cast<int>(_workers.size()); }
+        [[nodiscard]] bool isWorkerThread() const;
+
+    private:
+        struct Task {
+                TaskFn fn;
+                TaskGroup *group;
+        };
+        struct WorkerQueue {
+                std::mutex mutex;
+                std::deque<Task> tasks;
+        };
+
+        void workerMain(int workerIdx);
+        bool tryRunOne(int workerIdx);
+        bool popLocal(int workerIdx, Task &outTask);
+        bool steal(int thiefIdx, Task &outTask);
+        void execute(Task &task);
+
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
+        std::vector<std::thread> _workers;
+        std::atomic<uint32_t> _nextExternalQueue{0};
+
+        // sleeping when there's nothing to do
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCv;
+        std::atomic<int> _queuedCount{0};
+        std::atomic<bool> _stop{false};
+};
+
+// static dependency graph of tasks, build once and run as many time as needed
+class TaskGraph {
+    public:
+        int addTask(TaskFn task);  // return node id
+        void addDependency(int beforeId, int afterId);
+        // submit roots and block until every node finished
+        void run(TaskScheduler &scheduler);
+        void clear() { _nodes.clear(); }
+
+    private:
+        struct Node {
+                TaskFn fn;
+                std::vector<int> successors;
+                int dependencyCount = 0;
+                std::atomic<int> remaining{0};
+        };
+
+        void submitNode(TaskScheduler &scheduler, TaskGroup &group, int nodeId);
+
+        std::vector<std::unique_ptr<Node>> _nodes;
+};
+
+}  // namespace luna
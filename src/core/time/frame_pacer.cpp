@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <thread>
+
+#include "frame_pacer.hpp"
+
+namespace luna {
+
+bool FramePacer::initialise(FramePacerConfig config) {
+    _conf = config;
+    _spinThreshold = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float, std::milli>(_conf.spinThresholdMs));
+    setTargetFps(_conf.targetFps);
+
+    _lastFrameTime = Clock::now();
+    _nextDeadline = _lastFrameTime + _frameDuration;
+    return true;
+}
+
+void FramePacer::shutdown() {}
+
+void FramePacer::setTargetFps(int fps) {
+    _conf.targetFps = fps;
+    if (fps <= 0) {
+        _frameDuration = Clock::duration::zero();
+    } else {
+        _frameDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / fps));
+    }
+    _nextDeadline = Clock::now() + _frameDuration;
+}
+
+void FramePacer::waitNextFrame() {
+    if (_frameDuration > Clock::duration::zero()) {
+        // coarse sleep first, scheduler granularity can be a few ms so leave a margin
+        Clock::time_point now = Clock::now();
+        if (_nextDeadline - now > _spinThreshold) {
+            std::this_thread::sleep_for(_nextDeadline - now - _spinThreshold);
+        }
+        // spin the rest
+        while (Clock::now() < _nextDeadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    Clock::time_point now = Clock::now();
+    _rawDeltaTimeS = std::chrono::duration<float>(now - _lastFrameTime).count();
+    _deltaTimeS = std::min(_rawDeltaTimeS, _conf.maxDeltaS);
+    _lastFrameTime = now;
+    _frameCount++;
+
+    // keep cadence from the ideal deadline so small overshoot doesn't accumulate,
+    // but resync if we fall behind by a whole frame
+    _nextDeadline += _frameDuration;
+    if (_nextDeadline < now) {
+        _nextDeadline = now + _frameDuration;
+    }
+
+    // rolling history
+    float frameMs = _rawDeltaTimeS * 1000.0f;
+    if (_historySize == FRAME_HISTORY_SIZE) {
+        _historySumMs -= _frameTimeHistoryMs[_historyPos];
+    } else {
+        _historySize++;
+    }
+    _frameTimeHistoryMs[_historyPos] = frameMs;
+    _historySumMs += frameMs;
+    _historyPos = (_historyPos + 1) % FRAME_HISTORY_SIZE;
+}
+
+float FramePacer::getAverageFrameTimeMs() const {
+    if (_historySize == 0) return 0;
+    return static_cast<float>(_historySumMs / _historySize);
+}
+
+}  // namespace luna
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+
+#include "utils/common.hpp"
+
+// Frame pacing, replaces the old SDL_GetTicks busy loop
+// sleep for the coarse part of the frame and spin the last stretch on a high resolution clock
+
+namespace luna {
+
+constexpr int FRAME_HISTORY_SIZE = 240;
+
+struct FramePacerConfig {
+        int targetFps = 60;            // <= 0 means uncapped
+        float spinThresholdMs = 2.0f;  // os sleep is not precise, spin the remaining time
+        float maxDeltaS = 0.05f;       // clamp huge delta (ex, when stepping through debugger)
+};
+
+class FramePacer {
+    public:
+        bool initialise(FramePacerConfig config = {});
+        void shutdown();
+
+        // block until next frame deadline, then compute new delta time
+        void waitNextFrame();
+
+        // setter
+        void setTargetFps(int fps);
+
+        // getter
+        [[nodiscard]] int getTargetFps() const { return _conf.targetFps; }
+        [[nodiscard]] float getDeltaTime() const { return _deltaTimeS; }
+        [[nodiscard]] float getRawDeltaTime() const { return _rawDeltaTimeS; }
+        [[nodiscard]] uint64_t getFrameCount() const { return _frameCount; }
+        [[nodiscard]] float getAverageFrameTimeMs() const;
+        // history is a ring buffer in ms, getHistoryOffset() points to the oldest entry
+        [[nodiscard]] const std::array<float, FRAME_HISTORY_SIZE>& getFrameTimeHistory() const {
+            return _frameTimeHistoryMs;
+        }
+        [[nodiscard]] int getHistoryOffset() const { return _historyPos; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        FramePacerConfig _conf;
+        Clock::duration _frameDuration{};
+        Clock::duration _spinThreshold{};
+        Clock::time_point _lastFrameTime{};
+        Clock::time_point _nextDeadline{};
+
+        float _deltaTimeS = 0;
+        float _rawDeltaTimeS = 0;
+        uint64_t _frameCount = 0;
+
+        // rolling history
+        std::array<float, FRAME_HISTORY_SIZE> _frameTimeHistoryMs{};
+        int _historyPos = 0;
+        int _historySize = 0;
+        double _historySumMs = 0;
+};
+
+}  // namespace luna
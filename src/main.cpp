@@ -1,10 +1,63 @@
+#include <charconv>
+#include <cstring>
 #include <memory>
+#include <string>
 
 #include "core/engine.hpp"
 
-int main() {
+// keeps the default and warns on anything that isn't a whole number in range
+static void parseIntArg(const char *flag, const char *value, int minValue, int &out) {
+    int parsed = 0;
+    const char *end = value + strlen(value);
+    auto [ptr, ec] = std::from_chars(value, end, parsed);
+    if (ec != std::errc() || ptr != end || parsed < minValue) {
+        luna::SLog::get()->warn(fmt::format("invalid value {:s} for {:s}, expect integer >= {:d}",
+                                            value, flag, minValue));
+        return;
+    }
+    out = parsed;
+}
+
+// usage: luna [--headless] [--frames n] [--timing-out path]
+//             [--record-input path] [--replay-input path]
+//             [--profile-frames n] [--profile-out path] [--scene path]
+//             [--staging-mb n] [--cpu-draw]
+static luna::EngineConfig parseArgs(int argc, char *argv[]) {
+    luna::EngineConfig config{};
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            config.headless = true;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            parseIntArg(argv[i], argv[i + 1], 0, config.frameCount);
+            ++i;
+        } else if (strcmp(argv[i], "--timing-out") == 0 && i + 1 < argc) {
+            config.timingOutputPath = argv[++i];
+        } else if (strcmp(argv[i], "--record-input") == 0 && i + 1 < argc) {
+            config.recordInputPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay-input") == 0 && i + 1 < argc) {
+            config.replayInputPath = argv[++i];
+        } else if (strcmp(argv[i], "--profile-frames") == 0 && i + 1 < argc) {
+            parseIntArg(argv[i], argv[i + 1], 0, config.profileFrames);
+            ++i;
+        } else if (strcmp(argv[i], "--profile-out") == 0 && i + 1 < argc) {
+            config.profileOutputPath = argv[++i];
+        } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            config.scenePath = argv[++i];
+        } else if (strcmp(argv[i], "--staging-mb") == 0 && i + 1 < argc) {
+            parseIntArg(argv[i], argv[i + 1], 1, config.stagingRingMb);
+            ++i;
+        } else if (strcmp(argv[i], "--cpu-draw") == 0) {
+            config.gpuDriven = false;
+        } else {
+            luna::SLog::get()->warn(fmt::format("unknown argument {:s}", argv[i]));
+        }
+    }
+    return config;
+}
+
+int main(int argc, char *argv[]) {
     auto engine = std::make_shared<luna::Engine>();
-    if (!engine->initialize(engine)) {
+    if (!engine->initialize(engine, parseArgs(argc, argv))) {
         return 1;
     };
     engine->run();
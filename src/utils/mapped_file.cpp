@@ -0,0 +1,94 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace luna {
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path) {
+    close();
+    auto l = SLog::get();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        l->error(fmt::format("failed to open {:s} for mapping", path));
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        l->error(fmt::format("cannot map empty file {:s}", path));
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        l->error(fmt::format("failed to map {:s}", path));
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    _file = file;
+    _mapping = mapping;
+    _data = static_cast<const uint8_t *>(view);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (_data != nullptr) UnmapViewOfFile(_data);
+    if (_mapping != nullptr) CloseHandle(_mapping);
+    if (_file != nullptr) CloseHandle(_file);
+    _data = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path) {
+    close();
+    auto l = SLog::get();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        l->error(fmt::format("failed to open {:s} for mapping", path));
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        l->error(fmt::format("cannot map empty file {:s}", path));
+        ::close(fd);
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // mapping keeps its own reference
+    if (view == MAP_FAILED) {
+        l->error(fmt::format("failed to map {:s}", path));
+        return false;
+    }
+    // read front to back once
+    madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    _data = static_cast<const uint8_t *>(view);
+    _size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (_data != nullptr) munmap(const_cast<uint8_t *>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+}  // namespace luna
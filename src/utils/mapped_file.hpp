@@ -0,0 +1,33 @@
+#pragma once
+
+#include "utils/common.hpp"
+
+// Read only memory mapped file, pages are faulted in by the os as the data is touched
+// so a large file costs no read copy and no heap allocation
+
+namespace luna {
+
+class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool open(const std::string &path);
+        void close();
+
+        [[nodiscard]] const uint8_t *data() const { return _data; }
+        [[nodiscard]] size_t size() const { return _size; }
+        [[nodiscard]] bool isOpen() const { return _data != nullptr; }
+
+    private:
+        const uint8_t *_data = nullptr;
+        size_t _size = 0;
+#ifdef _WIN32
+        void *_file = nullptr;
+        void *_mapping = nullptr;
+#endif
+};
+
+}  // namespace luna